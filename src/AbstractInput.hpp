@@ -3,13 +3,19 @@
 
 #include "Types.hpp"
 #include "CommonReadState.hpp"
+#include "Footprint.hpp"
+#include "PackedBit.hpp"
+#include "PerValueReadState.hpp"
+#include "PayloadRegionIndex.hpp"
 #include "ReadCommand.hpp"
+#include "Scaling.hpp"
 
 #include <xentara/memory/Array.hpp>
 #include <xentara/memory/WriteSentinel.hpp>
 #include <xentara/utils/eh/expected.hpp>
 
 #include <chrono>
+#include <optional>
 #include <system_error>
 #include <cstdlib>
 
@@ -34,6 +40,28 @@ public:
 	/// @brief Gets the I/O component the input belongs to
 	/// @todo give this a more descriptive name, e.g. "_device"
 	virtual auto ioComponent() const -> const TemplateIoComponent & = 0;
+
+	/// @brief Gets the location of the input's data within the payload of the read command.
+	/// @return The location, or std::nullopt if the location is not known. If the location is not known, the input
+	/// will always be updated, even if only parts of the payload have changed.
+	virtual auto payloadRegion() const noexcept -> std::optional<PayloadRegion> = 0;
+
+	/// @brief Gets the read state of the input, if the input's value can be decoded in bulk together with other inputs
+	/// @return The read state, or std::monostate if the value cannot be decoded in bulk
+	virtual auto bulkReadState() noexcept -> BulkReadState = 0;
+
+	/// @brief Gets the read state of the input, if the input's value is scaled from a raw value
+	/// @return The read state, or std::nullopt if the value is not scaled
+	virtual auto scaledReadState() noexcept -> std::optional<ScaledReadState> = 0;
+
+	/// @brief Gets the read state of the input, if the input's value is a bit packed together with other bits
+	/// @return The read state, or std::nullopt if the value is not a packed bit
+	virtual auto packedBitReadState() noexcept -> std::optional<PackedBitReadState> = 0;
+
+	/// @brief Gets the memory used by the data type specific handler of the skill data point
+	///
+	/// This is part of AbstractInput rather than AbstractOutput, because all skill data points are inputs.
+	virtual auto handlerFootprint() const noexcept -> Footprint = 0;
 	
 	/// @brief Attaches the input to its I/O transaction
 	/// @param dataArray The data array that the attributes should be added to. The caller will use the information in this array
@@ -57,6 +85,12 @@ public:
 		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
 		const CommonReadState::Changes &commonChanges,
 		PendingEventList &eventsToRaise) -> void = 0;
+
+	/// @brief Carries the read state over unchanged from the last update.
+	///
+	/// This is called instead of updateReadState() if the payload of the read command is known to be identical to that of the last read.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	virtual auto keepReadState(WriteSentinel &writeSentinel) -> void = 0;
 };
 
 inline AbstractInput::~AbstractInput() = default;
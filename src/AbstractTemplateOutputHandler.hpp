@@ -3,6 +3,8 @@
 
 #include "Types.hpp"
 #include "CommonReadState.hpp"
+#include "Footprint.hpp"
+#include "PerValueReadState.hpp"
 #include "ReadCommand.hpp"
 
 #include <xentara/data/DataType.hpp>
@@ -41,6 +43,17 @@ public:
 	/// @brief Returns the data type
 	virtual auto dataType() const -> const data::DataType & = 0;
 
+	/// @brief Returns the number of bytes the value occupies in the payload of a read command
+	/// @return The size, or std::nullopt if the size is variable.
+	virtual auto encodedSize() const noexcept -> std::optional<std::size_t> = 0;
+
+	/// @brief Returns the read state, if the value can be decoded in bulk together with other values of the same type
+	/// @return The read state, or std::monostate if the value cannot be decoded in bulk
+	virtual auto bulkReadState() noexcept -> BulkReadState = 0;
+
+	/// @brief Returns the memory used by the handler
+	virtual auto footprint() const noexcept -> Footprint = 0;
+
 	/// @brief Iterates over all the attributes.
 	/// @param function The function that should be called for each attribute
 	/// @param ioTransaction The I/O transaction this output is attached to. This is used to handle inherited attributes.
@@ -92,16 +105,22 @@ public:
 	/// @param timeStamp The update time stamp
 	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
 	/// containing a read error.
+	/// @param offset The offset of the value within the payload, or std::nullopt if it is unknown
 	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
 	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this
 	/// list. The events will not be raised directly, because the write sentinel needs to be commited first,
 	/// which is done by the caller.
-	/// @todo add parameters needed to decode the value from the payload of a read command, like e.g. a data offset.
+	/// @todo add any other parameters needed to decode the value from the payload of a read command.
 	virtual auto updateReadState(WriteSentinel &writeSentinel,
 		std::chrono::system_clock::time_point timeStamp,
 		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		std::optional<std::size_t> offset,
 		const CommonReadState::Changes &commonChanges,
 		PendingEventList &eventsToRaise) -> void = 0;
+
+	/// @brief Carries the read state over unchanged from the last update.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	virtual auto keepReadState(WriteSentinel &writeSentinel) -> void = 0;
 		
 	/// @brief Attaches the write state to an I/O transaction
 	/// @param dataArray The data array that the attributes should be added to. The caller will use the information in this array
@@ -113,8 +132,10 @@ public:
 
 	/// @brief Adds any pending output value to a write command.
 	/// @param command The write command to add the value to.
+	/// @param offset The offset of the value within the data of the command, or std::nullopt if the output has no offset.
 	/// @return This function must return *true* if data was added, or *false* if no value was pending.
-	virtual auto addToWriteCommand(WriteCommand &command) -> bool = 0;
+	/// @todo add any other parameters needed to encode the value into a write command.
+	virtual auto addToWriteCommand(WriteCommand &command, std::optional<std::size_t> offset) -> bool = 0;
 
 	/// @brief Updates the write state and collects the events to send
 	/// @param writeSentinel A write sentinel for the data block the data is stored in
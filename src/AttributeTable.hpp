@@ -0,0 +1,79 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/model/Attribute.hpp>
+#include <xentara/utils/core/Uuid.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A table that maps Xentara attributes to the part of an element that handles them.
+///
+/// This is used to route a request for a read handle directly to the part of the element that can satisfy it, rather than
+/// asking each part in turn. The attributes are looked up by UUID using a hash table, so a lookup takes the same time
+/// regardless of the number of attributes, and regardless of whether the attribute is found or not.
+///
+/// The table is built from the attribute lists of the parts themselves, so that it always matches the attributes the
+/// parts report. Each class builds its table once, when the program starts.
+template <typename Route>
+class AttributeTable final
+{
+public:
+	/// @brief The result of a lookup
+	struct Match final
+	{
+		/// @brief The part of the element that handles the attribute
+		Route _route;
+		/// @brief The position of the attribute in the attribute list of that part
+		std::size_t _index;
+	};
+
+	/// @brief A list of attributes that are all handled by the same part of the element
+	struct Group final
+	{
+		/// @brief The attributes
+		std::span<const std::reference_wrapper<const model::Attribute>> _attributes;
+		/// @brief The part of the element that handles the attributes
+		Route _route;
+	};
+
+	/// @brief Constructor
+	/// @param groups The groups of attributes. The attribute lists only need to remain valid until the constructor returns.
+	AttributeTable(std::initializer_list<Group> groups)
+	{
+		for (auto &&group : groups)
+		{
+			for (std::size_t index = 0; index < group._attributes.size(); ++index)
+			{
+				_entries.emplace(group._attributes[index].get().uuid(), Match { group._route, index });
+			}
+		}
+	}
+
+	/// @brief Looks up an attribute
+	/// @param attribute The attribute
+	/// @return The part of the element that handles the attribute, or std::nullopt if the attribute is not in the table
+	auto find(const model::Attribute &attribute) const noexcept -> std::optional<Match>
+	{
+		const auto entry = _entries.find(attribute.uuid());
+		if (entry == _entries.end())
+		{
+			return std::nullopt;
+		}
+
+		return entry->second;
+	}
+
+private:
+	/// @brief The entries, keyed by attribute UUID
+	std::unordered_map<utils::core::Uuid, Match> _entries;
+};
+
+} // namespace xentara::plugins::templateDriver
@@ -21,4 +21,45 @@ const model::Attribute kConnectionTime { "deadbeef-dead-beef-dead-beefdeadbeef"_
 /// @todo assign a unique UUID
 const model::Attribute kDeviceError { "abababab-abab-abab-abab-abababababab"_uuid, "error"sv, model::Attribute::Access::ReadOnly, data::DataType::kErrorCode };
 
+/// @todo assign a unique UUID
+const model::Attribute kMemoryFootprint { "cdcdcdcd-cdcd-cdcd-cdcd-cdcdcdcdcdcd"_uuid, "memoryFootprint"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadLatency { "e1e1e1e1-e1e1-e1e1-e1e1-e1e1e1e1e1e1"_uuid, "readLatency"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kReadMaximumLatency { "e2e2e2e2-e2e2-e2e2-e2e2-e2e2e2e2e2e2"_uuid, "readMaximumLatency"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kReadDuration { "e3e3e3e3-e3e3-e3e3-e3e3-e3e3e3e3e3e3"_uuid, "readDuration"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kReadMaximumDuration { "e4e4e4e4-e4e4-e4e4-e4e4-e4e4e4e4e4e4"_uuid, "readMaximumDuration"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kReadOverruns { "e5e5e5e5-e5e5-e5e5-e5e5-e5e5e5e5e5e5"_uuid, "readOverruns"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kWriteLatency { "e6e6e6e6-e6e6-e6e6-e6e6-e6e6e6e6e6e6"_uuid, "writeLatency"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kWriteMaximumLatency { "e7e7e7e7-e7e7-e7e7-e7e7-e7e7e7e7e7e7"_uuid, "writeMaximumLatency"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kWriteDuration { "e8e8e8e8-e8e8-e8e8-e8e8-e8e8e8e8e8e8"_uuid, "writeDuration"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kWriteMaximumDuration { "e9e9e9e9-e9e9-e9e9-e9e9-e9e9e9e9e9e9"_uuid, "writeMaximumDuration"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kWriteOverruns { "eaeaeaea-eaea-eaea-eaea-eaeaeaeaeaea"_uuid, "writeOverruns"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kReconnectLatency { "ebebebeb-ebeb-ebeb-ebeb-ebebebebebeb"_uuid, "reconnectLatency"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kReconnectMaximumLatency { "ecececec-ecec-ecec-ecec-ecececececec"_uuid, "reconnectMaximumLatency"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kReconnectDuration { "edededed-eded-eded-eded-edededededed"_uuid, "reconnectDuration"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kReconnectMaximumDuration { "eeeeeeee-eeee-eeee-eeee-eeeeeeeeeeee"_uuid, "reconnectMaximumDuration"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kReconnectOverruns { "efefefef-efef-efef-efef-efefefefefef"_uuid, "reconnectOverruns"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kDeferredReads { "f1f1f1f1-f1f1-f1f1-f1f1-f1f1f1f1f1f1"_uuid, "deferredReads"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+/// @todo assign a unique UUID
+const model::Attribute kDroppedReads { "f2f2f2f2-f2f2-f2f2-f2f2-f2f2f2f2f2f2"_uuid, "droppedReads"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
 } // namespace xentara::plugins::templateDriver::attributes
@@ -17,4 +17,45 @@ extern const model::Attribute kConnectionTime;
 /// @brief A Xentara attribute containing an error code for an I/O component
 extern const model::Attribute kDeviceError;
 
+/// @brief A Xentara attribute containing the memory used by an I/O component or I/O transaction, in bytes
+extern const model::Attribute kMemoryFootprint;
+
+/// @brief A Xentara attribute containing the 99th percentile of the delay between the scheduled time and the actual start of the I/O transaction's read task, in microseconds
+extern const model::Attribute kReadLatency;
+/// @brief A Xentara attribute containing the maximum delay between the scheduled time and the actual start of the I/O transaction's read task, in microseconds
+extern const model::Attribute kReadMaximumLatency;
+/// @brief A Xentara attribute containing the 99th percentile of the execution time of the I/O transaction's read task, in microseconds
+extern const model::Attribute kReadDuration;
+/// @brief A Xentara attribute containing the maximum execution time of the I/O transaction's read task, in microseconds
+extern const model::Attribute kReadMaximumDuration;
+/// @brief A Xentara attribute containing the number of times the I/O transaction's read task took longer than its budget
+extern const model::Attribute kReadOverruns;
+
+/// @brief A Xentara attribute containing the 99th percentile of the delay between the scheduled time and the actual start of the I/O transaction's write task, in microseconds
+extern const model::Attribute kWriteLatency;
+/// @brief A Xentara attribute containing the maximum delay between the scheduled time and the actual start of the I/O transaction's write task, in microseconds
+extern const model::Attribute kWriteMaximumLatency;
+/// @brief A Xentara attribute containing the 99th percentile of the execution time of the I/O transaction's write task, in microseconds
+extern const model::Attribute kWriteDuration;
+/// @brief A Xentara attribute containing the maximum execution time of the I/O transaction's write task, in microseconds
+extern const model::Attribute kWriteMaximumDuration;
+/// @brief A Xentara attribute containing the number of times the I/O transaction's write task took longer than its budget
+extern const model::Attribute kWriteOverruns;
+
+/// @brief A Xentara attribute containing the 99th percentile of the delay between the scheduled time and the actual start of the I/O component's reconnect task, in microseconds
+extern const model::Attribute kReconnectLatency;
+/// @brief A Xentara attribute containing the maximum delay between the scheduled time and the actual start of the I/O component's reconnect task, in microseconds
+extern const model::Attribute kReconnectMaximumLatency;
+/// @brief A Xentara attribute containing the 99th percentile of the execution time of the I/O component's reconnect task, in microseconds
+extern const model::Attribute kReconnectDuration;
+/// @brief A Xentara attribute containing the maximum execution time of the I/O component's reconnect task, in microseconds
+extern const model::Attribute kReconnectMaximumDuration;
+/// @brief A Xentara attribute containing the number of times the I/O component's reconnect task took longer than its budget
+extern const model::Attribute kReconnectOverruns;
+
+/// @brief A Xentara attribute containing the number of times the read of an I/O transaction was deferred because the cycle budget was used up
+extern const model::Attribute kDeferredReads;
+/// @brief A Xentara attribute containing the number of times the pipelined read of an I/O transaction was dropped because the request window was full
+extern const model::Attribute kDroppedReads;
+
 } // namespace xentara::plugins::templateDriver::attributes
\ No newline at end of file
@@ -0,0 +1,147 @@
+// Copyright (c) embedded ocean GmbH
+#include "BulkInputRun.hpp"
+
+#include "ByteOrder.hpp"
+#include "CustomError.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+#include <type_traits>
+#include <variant>
+
+namespace xentara::plugins::templateDriver
+{
+
+template <typename ValueType>
+auto BulkInputRun<ValueType>::attachValues(memory::Array &dataArray) -> void
+{
+	for (auto &&state : _states)
+	{
+		state.get().attachValue(dataArray);
+	}
+}
+
+template <typename ValueType>
+auto BulkInputRun<ValueType>::updateReadStates(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+	const CommonReadState::Changes &commonChanges,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Decode the values, and determine the error if this fails
+	std::error_code error;
+	if (!payloadOrError)
+	{
+		error = payloadOrError.error();
+	}
+	else if (!decodeValues(writeSentinel, payloadOrError->get().data()))
+	{
+		error = CustomError::PayloadTooShort;
+	}
+
+	// Handle errors
+	if (error)
+	{
+		for (auto &&state : _states)
+		{
+			state.get().update(writeSentinel, timeStamp, utils::eh::unexpected(error), commonChanges, eventsToRaise);
+		}
+		return;
+	}
+
+	// Detect changes and collect the events
+	for (auto &&state : _states)
+	{
+		state.get().commitValue(writeSentinel, timeStamp, commonChanges, eventsToRaise);
+	}
+}
+
+template <typename ValueType>
+auto BulkInputRun<ValueType>::decodeValues(WriteSentinel &writeSentinel, std::span<const std::byte> data) -> bool
+{
+	// Make sure the payload contains all the values
+	const auto size = _states.size() * sizeof(ValueType);
+	if (_offset > data.size() || data.size() - _offset < size)
+	{
+		return false;
+	}
+	const auto encodedValues = data.subspan(_offset, size);
+
+	// Decode all the values in one go if they lie next to each other in the data block, which they always should
+	auto *values = &_states.front().get().value(writeSentinel);
+	if (&_states.back().get().value(writeSentinel) == values + (_states.size() - 1)) [[likely]]
+	{
+		byteOrder::decode(encodedValues, values);
+	}
+	// Decode the values one by one otherwise
+	else
+	{
+		for (std::size_t index = 0; index < _states.size(); ++index)
+		{
+			_states[index].get().value(writeSentinel) =
+				byteOrder::decode<ValueType>(encodedValues.data() + index * sizeof(ValueType));
+		}
+	}
+
+	return true;
+}
+
+auto bulkValueSize(const BulkReadState &state) noexcept -> std::size_t
+{
+	return std::visit(
+		[]<typename State>(State) -> std::size_t
+		{
+			if constexpr (std::is_pointer_v<State>)
+			{
+				return sizeof(typename std::remove_pointer_t<State>::Value);
+			}
+			else
+			{
+				return 0;
+			}
+		},
+		state);
+}
+
+auto makeBulkInputRun(std::size_t firstInput, std::span<const BulkReadState> states, std::size_t offset)
+	-> std::unique_ptr<AbstractBulkInputRun>
+{
+	return std::visit(
+		[&]<typename State>(State) -> std::unique_ptr<AbstractBulkInputRun>
+		{
+			if constexpr (std::is_pointer_v<State>)
+			{
+				using ValueType = typename std::remove_pointer_t<State>::Value;
+
+				// Collect the states
+				std::vector<std::reference_wrapper<PerValueReadState<ValueType>>> typedStates;
+				typedStates.reserve(states.size());
+				for (auto &&state : states)
+				{
+					typedStates.push_back(*std::get<State>(state));
+				}
+
+				return std::make_unique<BulkInputRun<ValueType>>(firstInput, std::move(typedStates), offset);
+			}
+			else
+			{
+				return nullptr;
+			}
+		},
+		states.front());
+}
+
+/// @class xentara::plugins::templateDriver::BulkInputRun
+/// @todo change list of template instantiations to the supported types
+template class BulkInputRun<std::uint8_t>;
+template class BulkInputRun<std::uint16_t>;
+template class BulkInputRun<std::uint32_t>;
+template class BulkInputRun<std::uint64_t>;
+template class BulkInputRun<std::int8_t>;
+template class BulkInputRun<std::int16_t>;
+template class BulkInputRun<std::int32_t>;
+template class BulkInputRun<std::int64_t>;
+template class BulkInputRun<float>;
+template class BulkInputRun<double>;
+
+} // namespace xentara::plugins::templateDriver
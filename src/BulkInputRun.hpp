@@ -0,0 +1,140 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "CommonReadState.hpp"
+#include "PerValueReadState.hpp"
+#include "ReadCommand.hpp"
+
+#include <xentara/memory/Array.hpp>
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A run of consecutive inputs of the same type, whose values lie next to each other in the payload of a read command.
+///
+/// The values of all the inputs in the run are placed next to each other in the data block as well, so that they can be decoded
+/// all at once, rather than one input at a time.
+class AbstractBulkInputRun
+{
+public:
+	/// @brief Constructor
+	/// @param firstInput The index of the first input of the run within the inputs of the I/O transaction
+	/// @param inputCount The number of inputs in the run
+	AbstractBulkInputRun(std::size_t firstInput, std::size_t inputCount) noexcept :
+		_firstInput(firstInput), _inputCount(inputCount)
+	{
+	}
+
+	/// @brief Virtual destructor
+	virtual ~AbstractBulkInputRun() = 0;
+
+	/// @brief Gets the index of the first input of the run within the inputs of the I/O transaction
+	auto firstInput() const noexcept -> std::size_t
+	{
+		return _firstInput;
+	}
+
+	/// @brief Gets the number of inputs in the run
+	auto inputCount() const noexcept -> std::size_t
+	{
+		return _inputCount;
+	}
+
+	/// @brief Adds the values of all the inputs to a data array.
+	///
+	/// This must be called before the inputs themselves are attached to the array.
+	/// @param dataArray The data array that the values should be added to.
+	virtual auto attachValues(memory::Array &dataArray) -> void = 0;
+
+	/// @brief Updates the read states of all the inputs and collects the events to send
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param timeStamp The update time stamp
+	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
+	/// containing a read error.
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this list.
+	virtual auto updateReadStates(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		const CommonReadState::Changes &commonChanges,
+		PendingEventList &eventsToRaise) -> void = 0;
+
+private:
+	/// @brief The index of the first input
+	std::size_t _firstInput;
+	/// @brief The number of inputs
+	std::size_t _inputCount;
+};
+
+inline AbstractBulkInputRun::~AbstractBulkInputRun() = default;
+
+/// @brief A run of inputs of a specific type
+template <typename ValueType>
+class BulkInputRun final : public AbstractBulkInputRun
+{
+public:
+	/// @brief Constructor
+	/// @param firstInput The index of the first input of the run within the inputs of the I/O transaction
+	/// @param states The read states of the inputs
+	/// @param offset The offset of the value of the first input within the payload of the read command
+	BulkInputRun(std::size_t firstInput, std::vector<std::reference_wrapper<PerValueReadState<ValueType>>> states, std::size_t offset) :
+		AbstractBulkInputRun(firstInput, states.size()), _states(std::move(states)), _offset(offset)
+	{
+	}
+
+	auto attachValues(memory::Array &dataArray) -> void final;
+
+	auto updateReadStates(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		const CommonReadState::Changes &commonChanges,
+		PendingEventList &eventsToRaise) -> void final;
+
+private:
+	/// @brief Decodes the values into the data block
+	/// @return true on success, or false if the payload is too short
+	auto decodeValues(WriteSentinel &writeSentinel, std::span<const std::byte> data) -> bool;
+
+	/// @brief The read states of the inputs
+	std::vector<std::reference_wrapper<PerValueReadState<ValueType>>> _states;
+	/// @brief The offset of the value of the first input within the payload of the read command
+	std::size_t _offset;
+};
+
+/// @brief Gets the size a value occupies in the payload of a read command, if it can be decoded in bulk
+/// @param state The read state of the value
+/// @return The size of the value in bytes, or 0 if the value cannot be decoded in bulk
+auto bulkValueSize(const BulkReadState &state) noexcept -> std::size_t;
+
+/// @brief Creates a bulk input run
+/// @param firstInput The index of the first input of the run within the inputs of the I/O transaction
+/// @param states The read states of the inputs. The states must all be of the same type, and must not be std::monostate.
+/// @param offset The offset of the value of the first input within the payload of the read command
+/// @return The new run
+auto makeBulkInputRun(std::size_t firstInput, std::span<const BulkReadState> states, std::size_t offset)
+	-> std::unique_ptr<AbstractBulkInputRun>;
+
+/// @class xentara::plugins::templateDriver::BulkInputRun
+/// @todo change list of extern template statements to the supported types
+extern template class BulkInputRun<std::uint8_t>;
+extern template class BulkInputRun<std::uint16_t>;
+extern template class BulkInputRun<std::uint32_t>;
+extern template class BulkInputRun<std::uint64_t>;
+extern template class BulkInputRun<std::int8_t>;
+extern template class BulkInputRun<std::int16_t>;
+extern template class BulkInputRun<std::int32_t>;
+extern template class BulkInputRun<std::int64_t>;
+extern template class BulkInputRun<float>;
+extern template class BulkInputRun<double>;
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,131 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "ConversionKernels.hpp"
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Functions for decoding values that are transmitted in the byte order of the I/O component
+/// @todo change the functions if the I/O component does not use big-endian byte order
+namespace byteOrder
+{
+
+/// @brief Concept for values that can be decoded by the functions in this namespace
+template <typename Type>
+concept Decodable = std::is_arithmetic_v<Type> && !std::same_as<Type, bool>;
+
+/// @brief Gets an unsigned integer type of the same size as another type
+template <std::size_t kSize>
+using UnsignedOfSize =
+	std::conditional_t<kSize == 1, std::uint8_t,
+		std::conditional_t<kSize == 2, std::uint16_t,
+			std::conditional_t<kSize == 4, std::uint32_t, std::uint64_t>>>;
+
+/// @brief Decodes a single big-endian value
+/// @param source The encoded value. Must contain at least sizeof(ValueType) bytes.
+/// @return The decoded value
+template <Decodable ValueType>
+auto decode(const std::byte *source) noexcept -> ValueType
+{
+	using Bits = UnsignedOfSize<sizeof(ValueType)>;
+
+	// Assemble the bits byte by byte, starting with the most significant byte. Compilers turn this into
+	// a single load and byte swap instruction.
+	Bits bits { 0 };
+	for (std::size_t index = 0; index < sizeof(ValueType); ++index)
+	{
+		bits = Bits((bits << 8) | std::to_integer<Bits>(source[index]));
+	}
+
+	return std::bit_cast<ValueType>(bits);
+}
+
+/// @brief Reverses the byte order of consecutive values
+/// @param source The values. Any bytes after the last full value are ignored.
+/// @param destination The destination. Must have room for the same number of bytes as *source*.
+template <std::size_t kSize>
+auto swapBytes(std::span<const std::byte> source, std::byte *destination) noexcept -> void
+{
+	if constexpr (kSize == 1)
+	{
+		std::memcpy(destination, source.data(), source.size());
+	}
+	else if constexpr (kSize == 2)
+	{
+		kernels::swapBytes16(source, destination);
+	}
+	else if constexpr (kSize == 4)
+	{
+		kernels::swapBytes32(source, destination);
+	}
+	else
+	{
+		kernels::swapBytes64(source, destination);
+	}
+}
+
+/// @brief Decodes a number of consecutive big-endian values
+/// @param source The encoded values. The number of values decoded is source.size() / sizeof(ValueType).
+/// @param destination The location to store the decoded values to. There must be enough room for all the values.
+template <Decodable ValueType>
+auto decode(std::span<const std::byte> source, ValueType *destination) noexcept -> void
+{
+	const auto byteCount = source.size() - source.size() % sizeof(ValueType);
+
+	// Big-endian processors need no conversion
+	if constexpr (std::endian::native == std::endian::big)
+	{
+		std::memcpy(destination, source.data(), byteCount);
+	}
+	else
+	{
+		swapBytes<sizeof(ValueType)>(source.first(byteCount), reinterpret_cast<std::byte *>(destination));
+	}
+}
+
+/// @brief Encodes a single value in big-endian byte order
+/// @param value The value to encode
+/// @param destination The location to store the encoded value to. Must have room for sizeof(ValueType) bytes.
+template <Decodable ValueType>
+auto encode(ValueType value, std::byte *destination) noexcept -> void
+{
+	using Bits = UnsignedOfSize<sizeof(ValueType)>;
+
+	// Store the bits byte by byte, starting with the most significant byte
+	auto bits = std::bit_cast<Bits>(value);
+	for (std::size_t index = sizeof(ValueType); index > 0; --index)
+	{
+		destination[index - 1] = std::byte(bits & 0xff);
+		bits = Bits(bits >> 8);
+	}
+}
+
+/// @brief Encodes a number of consecutive values in big-endian byte order
+/// @param values The values to encode
+/// @param destination The location to store the encoded values to. Must have room for values.size_bytes() bytes.
+template <Decodable ValueType>
+auto encode(std::span<const ValueType> values, std::byte *destination) noexcept -> void
+{
+	// Big-endian processors need no conversion
+	if constexpr (std::endian::native == std::endian::big)
+	{
+		std::memcpy(destination, values.data(), values.size_bytes());
+	}
+	else
+	{
+		swapBytes<sizeof(ValueType)>(std::as_bytes(values), destination);
+	}
+}
+
+} // namespace byteOrder
+
+} // namespace xentara::plugins::templateDriver
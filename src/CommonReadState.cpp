@@ -3,9 +3,11 @@
 
 #include "Attributes.hpp"
 #include "Events.hpp"
+#include "Footprint.hpp"
 
 #include <xentara/memory/WriteSentinel.hpp>
 
+#include <algorithm>
 #include <string_view>
 
 namespace xentara::plugins::templateDriver
@@ -13,13 +15,16 @@ namespace xentara::plugins::templateDriver
 
 using namespace std::literals;
 
+auto CommonReadState::attributes() noexcept -> std::array<std::reference_wrapper<const model::Attribute>, AttributeCount>
+{
+	// Return all the attributes we support, in the order given by AttributeIndex
+	return { { model::Attribute::kUpdateTime, model::Attribute::kQuality, attributes::kError } };
+}
+
 auto CommonReadState::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
 {
 	// Handle all the attributes we support
-	return
-		function(model::Attribute::kUpdateTime) ||
-		function(model::Attribute::kQuality) ||
-		function(attributes::kError);
+	return std::ranges::any_of(attributes(), [&](const model::Attribute &attribute) { return function(attribute); });
 }
 
 auto CommonReadState::forEachEvent(const model::ForEachEventFunction &function, std::shared_ptr<void> parent) -> bool
@@ -32,17 +37,26 @@ auto CommonReadState::forEachEvent(const model::ForEachEventFunction &function,
 auto CommonReadState::makeReadHandle(const DataBlock &dataBlock,
 	const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
 {
-	// Try each readable attribute
-	if (attribute == model::Attribute::kUpdateTime)
+	// Find the position of the attribute in our attribute list
+	const auto list = attributes();
+	const auto entry = std::ranges::find_if(list, [&](const model::Attribute &candidate) { return candidate == attribute; });
+	if (entry == list.end())
 	{
-		return dataBlock.member(_stateHandle, &State::_updateTime);
+		return std::nullopt;
 	}
-	else if (attribute == model::Attribute::kQuality)
+
+	return makeReadHandle(dataBlock, std::size_t(entry - list.begin()));
+}
+
+auto CommonReadState::makeReadHandle(const DataBlock &dataBlock, std::size_t index) const noexcept -> std::optional<data::ReadHandle>
+{
+	switch (index)
 	{
+	case UpdateTimeIndex:
+		return dataBlock.member(_stateHandle, &State::_updateTime);
+	case QualityIndex:
 		return dataBlock.member(_stateHandle, &State::_quality);
-	}
-	else if (attribute == attributes::kError)
-	{
+	case ErrorIndex:
 		return dataBlock.member(_stateHandle, &State::_error);
 	}
 
@@ -52,7 +66,7 @@ auto CommonReadState::makeReadHandle(const DataBlock &dataBlock,
 auto CommonReadState::attach(memory::Array &dataArray, std::size_t &eventCount) -> void
 {
 	// Add the state to the array
-	_stateHandle = dataArray.appendObject<State>();
+	_stateHandle = appendObject<State>(dataArray);
 
 	// Add the number of events that can be raised at once, which is just the one event we have.
 	eventCount += 1;
@@ -12,8 +12,10 @@
 #include <xentara/model/ForEachEventFunction.hpp>
 #include <xentara/process/Event.hpp>
 
+#include <array>
 #include <chrono>
 #include <concepts>
+#include <functional>
 #include <optional>
 #include <memory>
 
@@ -41,6 +43,24 @@ public:
 		}
 	};
 
+	/// @brief The positions of the attributes in the list returned by attributes()
+	enum AttributeIndex : std::size_t
+	{
+		/// @brief The position of the update time
+		UpdateTimeIndex,
+		/// @brief The position of the quality
+		QualityIndex,
+		/// @brief The position of the error
+		ErrorIndex,
+		/// @brief The number of attributes
+		AttributeCount
+	};
+
+	/// @brief Gets all the attributes that belong to this state, in the order given by AttributeIndex.
+	///
+	/// This is used by forEachAttribute(), and to build tables that map attributes to the states that handle them.
+	static auto attributes() noexcept -> std::array<std::reference_wrapper<const model::Attribute>, AttributeCount>;
+
 	/// @brief Iterates over all the attributes that belong to this state.
 	/// @param function The function that should be called for each attribute
 	/// @return The return value of the last function call
@@ -65,6 +85,13 @@ public:
 	auto makeReadHandle(const DataBlock &dataBlock, const model::Attribute &attribute) const noexcept
 		-> std::optional<data::ReadHandle>;
 
+	/// @brief Creates a read-handle for an attribute that belong to this state, given its position in attributes()
+	/// @param dataBlock The data block the data is stored in
+	/// @param index The position of the attribute in the list returned by attributes()
+	/// @return A read handle for the attribute, or std::nullopt if the index is out of range
+	auto makeReadHandle(const DataBlock &dataBlock, std::size_t index) const noexcept
+		-> std::optional<data::ReadHandle>;
+
 	/// @brief Attaches the state to its I/O transaction
 	/// @param dataArray The data array that the attributes should be added to. The caller will use the information in this array
 	/// to allocate the data block.
@@ -0,0 +1,371 @@
+// Copyright (c) embedded ocean GmbH
+#include "ConversionKernels.hpp"
+
+#include <array>
+#include <cstring>
+
+// Use SIMD instructions on x86 processors, if the compiler supports selecting the instruction set for individual functions
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#	define TEMPLATE_DRIVER_X86_KERNELS 1
+#	include <immintrin.h>
+#endif
+
+namespace xentara::plugins::templateDriver::kernels
+{
+
+namespace
+{
+
+/// @brief A permutation of the bytes within each element of a block of data
+struct Permutation
+{
+	/// @brief The size of the elements
+	std::size_t _elementSize;
+	/// @brief The source index of each byte within a 16-byte block. The pattern repeats for each element.
+	std::array<std::uint8_t, 16> _pattern;
+};
+
+constexpr Permutation kSwapBytes16 { 2, { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 } };
+constexpr Permutation kSwapBytes32 { 4, { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 } };
+constexpr Permutation kSwapBytes64 { 8, { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 } };
+constexpr Permutation kSwapWords32 { 4, { 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13 } };
+constexpr Permutation kSwapWords64 { 8, { 6, 7, 4, 5, 2, 3, 0, 1, 14, 15, 12, 13, 10, 11, 8, 9 } };
+
+/// @brief A set of implementations of the kernels
+struct KernelTable
+{
+	/// @brief The instruction set the kernels are implemented with
+	InstructionSet _instructionSet;
+	/// @brief Permutes the bytes of each element. The byte count must be a multiple of the element size.
+	void (*_permute)(const std::byte *source, std::byte *destination, std::size_t byteCount, const Permutation &permutation) noexcept;
+	/// @brief Implements scaleBigEndianInt16()
+	void (*_scaleBigEndianInt16)(const std::byte *source, float *destination, std::size_t count, float scale, float offset) noexcept;
+	/// @brief Implements extractBits()
+	void (*_extractBits)(const std::byte *source, std::size_t firstBit, bool *destination, std::size_t count) noexcept;
+};
+
+/// @name Scalar Implementations
+/// @{
+
+auto permuteScalar(const std::byte *source, std::byte *destination, std::size_t byteCount, const Permutation &permutation) noexcept
+	-> void
+{
+	for (std::size_t offset = 0; offset < byteCount; offset += permutation._elementSize)
+	{
+		for (std::size_t index = 0; index < permutation._elementSize; ++index)
+		{
+			destination[offset + index] = source[offset + permutation._pattern[index]];
+		}
+	}
+}
+
+auto scaleBigEndianInt16Scalar(const std::byte *source, float *destination, std::size_t count, float scale, float offset) noexcept
+	-> void
+{
+	for (std::size_t index = 0; index < count; ++index)
+	{
+		const auto bits = std::uint16_t((std::to_integer<std::uint16_t>(source[index * 2]) << 8) |
+			std::to_integer<std::uint16_t>(source[index * 2 + 1]));
+		destination[index] = float(std::int16_t(bits)) * scale + offset;
+	}
+}
+
+auto extractBitsScalar(const std::byte *source, std::size_t firstBit, bool *destination, std::size_t count) noexcept -> void
+{
+	for (std::size_t index = 0; index < count; ++index)
+	{
+		const auto bit = firstBit + index;
+		destination[index] = ((std::to_integer<unsigned>(source[bit / 8]) >> (bit % 8)) & 1u) != 0;
+	}
+}
+
+constexpr KernelTable kScalarKernels { InstructionSet::Scalar, permuteScalar, scaleBigEndianInt16Scalar, extractBitsScalar };
+
+/// @}
+
+#if defined(TEMPLATE_DRIVER_X86_KERNELS)
+
+/// @name SSE 4.1 Implementations
+/// @{
+
+[[gnu::target("sse4.1")]] auto permuteSse4(
+	const std::byte *source, std::byte *destination, std::size_t byteCount, const Permutation &permutation) noexcept -> void
+{
+	const auto pattern = _mm_loadu_si128(reinterpret_cast<const __m128i *>(permutation._pattern.data()));
+
+	// Permute 16 bytes at a time. The element sizes all divide 16, so the remaining bytes always contain whole elements.
+	std::size_t offset { 0 };
+	for (; offset + 16 <= byteCount; offset += 16)
+	{
+		const auto data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + offset));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + offset), _mm_shuffle_epi8(data, pattern));
+	}
+	permuteScalar(source + offset, destination + offset, byteCount - offset, permutation);
+}
+
+[[gnu::target("sse4.1")]] auto scaleBigEndianInt16Sse4(
+	const std::byte *source, float *destination, std::size_t count, float scale, float offset) noexcept -> void
+{
+	const auto swap = _mm_loadu_si128(reinterpret_cast<const __m128i *>(kSwapBytes16._pattern.data()));
+	const auto scaleVector = _mm_set1_ps(scale);
+	const auto offsetVector = _mm_set1_ps(offset);
+
+	// Convert 8 values at a time
+	std::size_t index { 0 };
+	for (; index + 8 <= count; index += 8)
+	{
+		const auto data = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + index * 2)), swap);
+		const auto low = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(data));
+		const auto high = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(data, 8)));
+		_mm_storeu_ps(destination + index, _mm_add_ps(_mm_mul_ps(low, scaleVector), offsetVector));
+		_mm_storeu_ps(destination + index + 4, _mm_add_ps(_mm_mul_ps(high, scaleVector), offsetVector));
+	}
+	scaleBigEndianInt16Scalar(source + index * 2, destination + index, count - index, scale, offset);
+}
+
+[[gnu::target("sse4.1")]] auto extractBitsSse4(const std::byte *source, std::size_t firstBit, bool *destination, std::size_t count) noexcept
+	-> void
+{
+	// Extract single bits until we reach a byte boundary
+	std::size_t index { 0 };
+	for (; index < count && (firstBit + index) % 8 != 0; ++index)
+	{
+		extractBitsScalar(source, firstBit + index, destination + index, 1);
+	}
+
+	// Spread each of two bytes over 8 bytes, and then check a different bit in each byte
+	const auto spread = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+	const auto bitMask = _mm_set1_epi64x(0x8040201008040201);
+	const auto one = _mm_set1_epi8(1);
+
+	// Extract 16 bits at a time
+	for (; index + 16 <= count; index += 16)
+	{
+		std::uint16_t bits;
+		std::memcpy(&bits, source + (firstBit + index) / 8, sizeof(bits));
+		const auto data = _mm_shuffle_epi8(_mm_set1_epi16(std::int16_t(bits)), spread);
+		const auto set = _mm_cmpeq_epi8(_mm_and_si128(data, bitMask), bitMask);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index), _mm_and_si128(set, one));
+	}
+	extractBitsScalar(source, firstBit + index, destination + index, count - index);
+}
+
+constexpr KernelTable kSse4Kernels { InstructionSet::Sse4, permuteSse4, scaleBigEndianInt16Sse4, extractBitsSse4 };
+
+/// @}
+
+/// @name AVX2 Implementations
+/// @{
+
+[[gnu::target("avx2")]] auto permuteAvx2(
+	const std::byte *source, std::byte *destination, std::size_t byteCount, const Permutation &permutation) noexcept -> void
+{
+	// The shuffle instruction works on each 16-byte lane separately, so we can just use the same pattern for both lanes
+	const auto pattern = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(permutation._pattern.data())));
+
+	// Permute 32 bytes at a time. The element sizes all divide 32, so the remaining bytes always contain whole elements.
+	std::size_t offset { 0 };
+	for (; offset + 32 <= byteCount; offset += 32)
+	{
+		const auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + offset));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + offset), _mm256_shuffle_epi8(data, pattern));
+	}
+	permuteScalar(source + offset, destination + offset, byteCount - offset, permutation);
+}
+
+[[gnu::target("avx2")]] auto scaleBigEndianInt16Avx2(
+	const std::byte *source, float *destination, std::size_t count, float scale, float offset) noexcept -> void
+{
+	const auto swap = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(kSwapBytes16._pattern.data())));
+	const auto scaleVector = _mm256_set1_ps(scale);
+	const auto offsetVector = _mm256_set1_ps(offset);
+
+	// Convert 16 values at a time
+	std::size_t index { 0 };
+	for (; index + 16 <= count; index += 16)
+	{
+		const auto data = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + index * 2)), swap);
+		const auto low = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(data)));
+		const auto high = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(data, 1)));
+		_mm256_storeu_ps(destination + index, _mm256_add_ps(_mm256_mul_ps(low, scaleVector), offsetVector));
+		_mm256_storeu_ps(destination + index + 8, _mm256_add_ps(_mm256_mul_ps(high, scaleVector), offsetVector));
+	}
+	scaleBigEndianInt16Scalar(source + index * 2, destination + index, count - index, scale, offset);
+}
+
+[[gnu::target("avx2")]] auto extractBitsAvx2(const std::byte *source, std::size_t firstBit, bool *destination, std::size_t count) noexcept
+	-> void
+{
+	// Extract single bits until we reach a byte boundary
+	std::size_t index { 0 };
+	for (; index < count && (firstBit + index) % 8 != 0; ++index)
+	{
+		extractBitsScalar(source, firstBit + index, destination + index, 1);
+	}
+
+	// Spread each of four bytes over 8 bytes, and then check a different bit in each byte. The shuffle instruction works on
+	// each 16-byte lane separately, but since all four bytes are present in both lanes, this does not matter.
+	const auto spread = _mm256_setr_epi8(
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+		2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+	const auto bitMask = _mm256_set1_epi64x(0x8040201008040201);
+	const auto one = _mm256_set1_epi8(1);
+
+	// Extract 32 bits at a time
+	for (; index + 32 <= count; index += 32)
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, source + (firstBit + index) / 8, sizeof(bits));
+		const auto data = _mm256_shuffle_epi8(_mm256_set1_epi32(std::int32_t(bits)), spread);
+		const auto set = _mm256_cmpeq_epi8(_mm256_and_si256(data, bitMask), bitMask);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + index), _mm256_and_si256(set, one));
+	}
+	extractBitsScalar(source, firstBit + index, destination + index, count - index);
+}
+
+constexpr KernelTable kAvx2Kernels { InstructionSet::Avx2, permuteAvx2, scaleBigEndianInt16Avx2, extractBitsAvx2 };
+
+/// @}
+
+#endif // defined(TEMPLATE_DRIVER_X86_KERNELS)
+
+/// @brief Checks a set of kernels against the scalar implementation
+auto selfTest(const KernelTable &kernels) noexcept -> bool
+{
+	// Use sizes that are not multiples of the SIMD register sizes, so that the handling of the remaining data is tested, too
+	constexpr std::size_t kByteCount = 8 * 37;
+	constexpr std::size_t kFirstBit = 5;
+	constexpr std::size_t kBitCount = kByteCount * 8 - kFirstBit - 11;
+
+	// Fill the source data with a pseudo-random pattern
+	std::array<std::byte, kByteCount> source;
+	std::uint32_t seed { 0x12345678 };
+	for (auto &&byte : source)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		byte = std::byte(seed >> 24);
+	}
+
+	// Check the permutations
+	for (const auto *permutation : { &kSwapBytes16, &kSwapBytes32, &kSwapBytes64, &kSwapWords32, &kSwapWords64 })
+	{
+		std::array<std::byte, kByteCount> expected;
+		std::array<std::byte, kByteCount> actual;
+		permuteScalar(source.data(), expected.data(), kByteCount, *permutation);
+		kernels._permute(source.data(), actual.data(), kByteCount, *permutation);
+		if (expected != actual)
+		{
+			return false;
+		}
+	}
+
+	// Check the scaling. We compare the bit patterns, since the results must be identical, not just close.
+	{
+		std::array<float, kByteCount / 2> expected;
+		std::array<float, kByteCount / 2> actual;
+		scaleBigEndianInt16Scalar(source.data(), expected.data(), expected.size(), 0.1f, -3.5f);
+		kernels._scaleBigEndianInt16(source.data(), actual.data(), actual.size(), 0.1f, -3.5f);
+		if (std::memcmp(expected.data(), actual.data(), sizeof(expected)) != 0)
+		{
+			return false;
+		}
+	}
+
+	// Check the bit extraction
+	{
+		std::array<bool, kBitCount> expected;
+		std::array<bool, kBitCount> actual;
+		extractBitsScalar(source.data(), kFirstBit, expected.data(), kBitCount);
+		kernels._extractBits(source.data(), kFirstBit, actual.data(), kBitCount);
+		if (expected != actual)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// @brief Selects the best kernels that the processor supports
+auto selectKernels() noexcept -> const KernelTable &
+{
+#if defined(TEMPLATE_DRIVER_X86_KERNELS)
+	__builtin_cpu_init();
+
+	// Use the best instruction set that is supported, and produces correct results
+	if (__builtin_cpu_supports("avx2") && selfTest(kAvx2Kernels))
+	{
+		return kAvx2Kernels;
+	}
+	if (__builtin_cpu_supports("sse4.1") && selfTest(kSse4Kernels))
+	{
+		return kSse4Kernels;
+	}
+#endif
+
+	return kScalarKernels;
+}
+
+/// @brief Gets the kernels to use
+auto activeKernels() noexcept -> const KernelTable &
+{
+	static const auto &kernels = selectKernels();
+	return kernels;
+}
+
+/// @brief Applies a permutation to a span of data
+auto permute(std::span<const std::byte> source, std::byte *destination, const Permutation &permutation) noexcept -> void
+{
+	// Only permute whole elements
+	const auto byteCount = source.size() - source.size() % permutation._elementSize;
+	activeKernels()._permute(source.data(), destination, byteCount, permutation);
+}
+
+} // namespace
+
+auto instructionSet() noexcept -> InstructionSet
+{
+	return activeKernels()._instructionSet;
+}
+
+auto swapBytes16(std::span<const std::byte> source, std::byte *destination) noexcept -> void
+{
+	permute(source, destination, kSwapBytes16);
+}
+
+auto swapBytes32(std::span<const std::byte> source, std::byte *destination) noexcept -> void
+{
+	permute(source, destination, kSwapBytes32);
+}
+
+auto swapBytes64(std::span<const std::byte> source, std::byte *destination) noexcept -> void
+{
+	permute(source, destination, kSwapBytes64);
+}
+
+auto swapWords32(std::span<const std::byte> source, std::byte *destination) noexcept -> void
+{
+	permute(source, destination, kSwapWords32);
+}
+
+auto swapWords64(std::span<const std::byte> source, std::byte *destination) noexcept -> void
+{
+	permute(source, destination, kSwapWords64);
+}
+
+auto scaleBigEndianInt16(std::span<const std::byte> source, float *destination, float scale, float offset) noexcept -> void
+{
+	activeKernels()._scaleBigEndianInt16(source.data(), destination, source.size() / 2, scale, offset);
+}
+
+auto extractBits(std::span<const std::byte> source, std::size_t firstBit, std::span<bool> destination) noexcept -> void
+{
+	activeKernels()._extractBits(source.data(), firstBit, destination.data(), destination.size());
+}
+
+auto selfTest() noexcept -> bool
+{
+	return selfTest(activeKernels());
+}
+
+} // namespace xentara::plugins::templateDriver::kernels
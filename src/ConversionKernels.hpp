@@ -0,0 +1,83 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Optimized functions for converting large amounts of data between the format used by the I/O component and the
+/// format used in memory.
+///
+/// The functions use SIMD instructions if the processor supports them. The implementation to use is selected once, at run time.
+/// Before an optimized implementation is used, it is checked against the portable implementation, and is only used if the
+/// results are identical.
+///
+/// All the functions can be used for decoding as well as encoding data.
+namespace kernels
+{
+
+/// @brief The instruction sets that the kernels can be implemented with
+enum class InstructionSet
+{
+	/// @brief Portable C++ code
+	Scalar,
+	/// @brief SSE up to version 4.1
+	Sse4,
+	/// @brief AVX2
+	Avx2
+};
+
+/// @brief Gets the instruction set that is used by the kernels
+auto instructionSet() noexcept -> InstructionSet;
+
+/// @brief Reverses the order of the bytes within each 16-bit element
+/// @param source The source data. Any bytes after the last full element are ignored.
+/// @param destination The destination. Must have room for the same number of bytes as *source*, and must not overlap it.
+auto swapBytes16(std::span<const std::byte> source, std::byte *destination) noexcept -> void;
+/// @brief Reverses the order of the bytes within each 32-bit element
+/// @param source The source data. Any bytes after the last full element are ignored.
+/// @param destination The destination. Must have room for the same number of bytes as *source*, and must not overlap it.
+auto swapBytes32(std::span<const std::byte> source, std::byte *destination) noexcept -> void;
+/// @brief Reverses the order of the bytes within each 64-bit element
+/// @param source The source data. Any bytes after the last full element are ignored.
+/// @param destination The destination. Must have room for the same number of bytes as *source*, and must not overlap it.
+auto swapBytes64(std::span<const std::byte> source, std::byte *destination) noexcept -> void;
+
+/// @brief Reverses the order of the 16-bit words within each 32-bit element, without changing the order of the bytes within the words.
+///
+/// This converts between the "ABCD" and "CDAB" layouts.
+/// @param source The source data. Any bytes after the last full element are ignored.
+/// @param destination The destination. Must have room for the same number of bytes as *source*, and must not overlap it.
+auto swapWords32(std::span<const std::byte> source, std::byte *destination) noexcept -> void;
+/// @brief Reverses the order of the 16-bit words within each 64-bit element, without changing the order of the bytes within the words.
+/// @param source The source data. Any bytes after the last full element are ignored.
+/// @param destination The destination. Must have room for the same number of bytes as *source*, and must not overlap it.
+auto swapWords64(std::span<const std::byte> source, std::byte *destination) noexcept -> void;
+
+/// @brief Converts big-endian 16-bit signed integers to scaled floating point values.
+///
+/// Each value is computed as *value* * *scale* + *offset*.
+/// @param source The encoded integers. Any bytes after the last full integer are ignored.
+/// @param destination The destination. Must have room for one value for each integer in *source*.
+/// @param scale The factor to multiply each integer with
+/// @param offset The offset to add to each value after scaling
+auto scaleBigEndianInt16(std::span<const std::byte> source, float *destination, float scale, float offset) noexcept -> void;
+
+/// @brief Extracts packed bits into individual Boolean values.
+///
+/// The bits are numbered starting with the least significant bit of the first byte.
+/// @param source The packed bits. Must contain at least *firstBit* + *destination.size()* bits.
+/// @param firstBit The number of the first bit to extract
+/// @param destination The destination. One bit is extracted for each element.
+auto extractBits(std::span<const std::byte> source, std::size_t firstBit, std::span<bool> destination) noexcept -> void;
+
+/// @brief Checks the kernels in use against the portable implementation.
+/// @return true if all kernels produce the same results as the portable implementation.
+auto selfTest() noexcept -> bool;
+
+} // namespace kernels
+
+} // namespace xentara::plugins::templateDriver
@@ -47,6 +47,18 @@ namespace
 		case CustomError::NoData:
 			return "no data was read yet"s;
 
+		case CustomError::Timeout:
+			return "the device did not respond in time"s;
+
+		case CustomError::KeepAliveTimeout:
+			return "the device did not respond to the keepalive probe in time"s;
+
+		case CustomError::PayloadTooShort:
+			return "the response from the device is too short"s;
+
+		case CustomError::SimulatedError:
+			return "a simulated error occurred"s;
+
 		/// @todo Add messages for other error codes
 
 		case CustomError::UnknownError:
@@ -19,6 +19,14 @@ enum class CustomError
 	NotConnected,
 	/// @brief No data has been read yet.
 	NoData,
+	/// @brief No response to a request was received in time.
+	Timeout,
+	/// @brief No response to a keepalive probe was received in time. Unlike Timeout, this means that the connection is lost.
+	KeepAliveTimeout,
+	/// @brief The data received from the device was too short to contain a value.
+	PayloadTooShort,
+	/// @brief An error was injected by the Simulator.
+	SimulatedError,
 
 	/// @brief An unknown error occurred
 	UnknownError = 999
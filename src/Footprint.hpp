@@ -0,0 +1,109 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/memory/Array.hpp>
+#include <xentara/utils/tools/Unique.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief The amount of memory used by an element, broken down by purpose.
+///
+/// All sizes are in bytes. Memory allocated dynamically by the values themselves, like the characters of strings, is not included.
+struct Footprint final
+{
+	/// @brief The memory used by the data arrays
+	std::uint64_t _dataBytes { 0 };
+	/// @brief The memory used by the buffers that collect events to raise
+	std::uint64_t _eventBufferBytes { 0 };
+	/// @brief The memory used by the buffers that collect outputs to notify
+	std::uint64_t _outputListBytes { 0 };
+	/// @brief The memory used by the data type specific handlers of the skill data points
+	std::uint64_t _handlerBytes { 0 };
+	/// @brief The memory used by the queues of pending output values
+	std::uint64_t _queueBytes { 0 };
+
+	/// @brief Gets the total memory used
+	auto total() const noexcept -> std::uint64_t
+	{
+		return _dataBytes + _eventBufferBytes + _outputListBytes + _handlerBytes + _queueBytes;
+	}
+
+	/// @brief Adds the memory used by something else
+	auto operator+=(const Footprint &other) noexcept -> Footprint &
+	{
+		_dataBytes += other._dataBytes;
+		_eventBufferBytes += other._eventBufferBytes;
+		_outputListBytes += other._outputListBytes;
+		_handlerBytes += other._handlerBytes;
+		_queueBytes += other._queueBytes;
+		return *this;
+	}
+};
+
+/// @brief The data published in the memory footprint attribute
+struct FootprintState final
+{
+	/// @brief The total memory used, in bytes
+	std::uint64_t _totalBytes { 0 };
+};
+
+/// @brief Counts the memory used by objects added to data arrays.
+///
+/// While an object of this class exists, all objects added to any data array using appendObject() on the same thread are counted.
+class DataArrayFootprint final : private utils::tools::Unique
+{
+public:
+	/// @brief Starts counting
+	DataArrayFootprint() noexcept : _previous(_current)
+	{
+		_current = this;
+	}
+
+	/// @brief Stops counting
+	~DataArrayFootprint()
+	{
+		_current = _previous;
+	}
+
+	/// @brief Gets the number of bytes counted so far
+	auto bytes() const noexcept -> std::size_t
+	{
+		return _bytes;
+	}
+
+	/// @brief Counts an object
+	/// @param size The size of the object
+	/// @param alignment The alignment of the object. Any padding needed to align the object is counted as well.
+	static auto count(std::size_t size, std::size_t alignment) noexcept -> void
+	{
+		if (_current)
+		{
+			_current->_bytes = (_current->_bytes + alignment - 1) / alignment * alignment + size;
+		}
+	}
+
+private:
+	/// @brief The number of bytes counted
+	std::size_t _bytes { 0 };
+	/// @brief The object that was counting before this one was created
+	DataArrayFootprint *_previous;
+
+	/// @brief The object that is currently counting, if any
+	static inline thread_local DataArrayFootprint *_current { nullptr };
+};
+
+/// @brief Adds an object to a data array, and counts its size in the current DataArrayFootprint, if any.
+/// @param dataArray The data array
+/// @return A handle to the new object
+template <typename Object>
+auto appendObject(memory::Array &dataArray) -> memory::Array::ObjectHandle<Object>
+{
+	DataArrayFootprint::count(sizeof(Object), alignof(Object));
+	return dataArray.appendObject<Object>();
+}
+
+} // namespace xentara::plugins::templateDriver
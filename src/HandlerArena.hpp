@@ -0,0 +1,62 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/utils/tools/Unique.hpp>
+
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief An arena that the data type specific handlers of skill data points are allocated from.
+///
+/// Allocating the handlers from an arena places the handlers of data points that are loaded one after the other next to each
+/// other in memory, instead of scattering them across the heap. This improves the cache locality when the I/O transactions
+/// update the data points.
+///
+/// The memory of the arena is only released when the arena itself is destroyed. Objects that hold pointers to handlers in the
+/// arena should therefore also hold a shared pointer to the arena, so that it is kept alive as long as the handlers are in use.
+class HandlerArena final : private utils::tools::Unique
+{
+public:
+	/// @brief A deleter that destroys an object allocated from the arena, without freeing its memory
+	struct Deleter
+	{
+		/// @brief Destroys the object
+		template <typename Object>
+		auto operator()(Object *object) const noexcept -> void
+		{
+			std::destroy_at(object);
+		}
+	};
+
+	/// @brief A unique pointer to an object allocated from the arena
+	template <typename Object>
+	using Pointer = std::unique_ptr<Object, Deleter>;
+
+	/// @brief Creates an object in the arena
+	/// @param arguments The arguments to pass to the constructor
+	/// @return A pointer to the new object
+	template <typename Object, typename... Arguments>
+	auto make(Arguments &&...arguments) -> Pointer<Object>
+	{
+		auto *memory = _memoryResource.allocate(sizeof(Object), alignof(Object));
+		try
+		{
+			return Pointer<Object>(std::construct_at(static_cast<Object *>(memory), std::forward<Arguments>(arguments)...));
+		}
+		catch (...)
+		{
+			_memoryResource.deallocate(memory, sizeof(Object), alignof(Object));
+			throw;
+		}
+	}
+
+private:
+	/// @brief The memory resource that manages the memory of the arena
+	std::pmr::monotonic_buffer_resource _memoryResource;
+};
+
+} // namespace xentara::plugins::templateDriver
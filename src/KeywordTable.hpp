@@ -0,0 +1,55 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A table that maps configuration keywords to values.
+///
+/// The table is sorted at compile time, so that a keyword can be looked up using a binary search, rather than by comparing
+/// it against each keyword in turn. This speeds up loading models with a large number of skill data points.
+template <typename Value, std::size_t kSize>
+class KeywordTable final
+{
+public:
+	/// @brief An entry in the table
+	struct Entry final
+	{
+		/// @brief The keyword
+		std::string_view _keyword;
+		/// @brief The value
+		Value _value;
+	};
+
+	/// @brief Constructor
+	/// @param entries The entries. The keywords must be unique, but need not be sorted.
+	consteval KeywordTable(std::array<Entry, kSize> entries) : _entries(entries)
+	{
+		std::ranges::sort(_entries, {}, &Entry::_keyword);
+	}
+
+	/// @brief Looks up a keyword
+	/// @param keyword The keyword
+	/// @return A pointer to the value, or nullptr if the keyword is not in the table
+	constexpr auto find(std::string_view keyword) const noexcept -> const Value *
+	{
+		const auto entry = std::ranges::lower_bound(_entries, keyword, {}, &Entry::_keyword);
+		if (entry == _entries.end() || entry->_keyword != keyword)
+		{
+			return nullptr;
+		}
+
+		return &entry->_value;
+	}
+
+private:
+	/// @brief The entries, sorted by keyword
+	std::array<Entry, kSize> _entries;
+};
+
+} // namespace xentara::plugins::templateDriver
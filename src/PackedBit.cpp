@@ -0,0 +1,36 @@
+// Copyright (c) embedded ocean GmbH
+#include "PackedBit.hpp"
+
+#include "CustomError.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto PackedBitReadState::update(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+	const CommonReadState::Changes &commonChanges,
+	PendingEventList &eventsToRaise) const -> void
+{
+	// Handle read errors
+	if (!payloadOrError)
+	{
+		_state.get().update(writeSentinel, timeStamp, utils::eh::unexpected(payloadOrError.error()), commonChanges, eventsToRaise);
+		return;
+	}
+
+	// Make sure the payload contains the bit
+	const auto data = payloadOrError->get().data();
+	if (_bit / 8 >= data.size())
+	{
+		_state.get().update(writeSentinel, timeStamp, utils::eh::unexpected(std::error_code(CustomError::PayloadTooShort)), commonChanges, eventsToRaise);
+		return;
+	}
+
+	// Decode the value
+	_state.get().update(writeSentinel, timeStamp, testBit(data, _bit), commonChanges, eventsToRaise);
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,53 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "CommonReadState.hpp"
+#include "PerValueReadState.hpp"
+#include "ReadCommand.hpp"
+
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <system_error>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Gets the value of a single bit of a payload
+///
+/// The bits are numbered starting with the least significant bit of the first byte.
+/// @todo change the bit numbering if the I/O component numbers the bits of its registers differently
+inline auto testBit(std::span<const std::byte> data, std::size_t bit) noexcept -> bool
+{
+	return ((std::to_integer<unsigned>(data[bit / 8]) >> (bit % 8)) & 1u) != 0;
+}
+
+/// @brief The read state of a Boolean input whose value is a single bit packed together with other bits
+struct PackedBitReadState final
+{
+	/// @brief The read state the value is stored in
+	std::reference_wrapper<PerValueReadState<bool>> _state;
+	/// @brief The number of the bit within the payload of the read command, as used by testBit().
+	std::size_t _bit { 0 };
+
+	/// @brief Decodes the value of this input alone, and collects the events to send
+	///
+	/// This is used if the input is updated on its own rather than together with the other packed bits of the I/O transaction.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param timeStamp The update time stamp
+	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
+	/// containing a read error.
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this list.
+	auto update(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		const CommonReadState::Changes &commonChanges,
+		PendingEventList &eventsToRaise) const -> void;
+};
+
+} // namespace xentara::plugins::templateDriver
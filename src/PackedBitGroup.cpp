@@ -0,0 +1,172 @@
+// Copyright (c) embedded ocean GmbH
+#include "PackedBitGroup.hpp"
+
+#include "ConversionKernels.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto PackedBitGroup::add(AbstractInput &input, const PackedBitReadState &state) -> void
+{
+	_members.push_back({ ._input = input, ._state = state._state, ._bit = state._bit });
+}
+
+auto PackedBitGroup::attachInputs(memory::Array &dataArray, std::size_t &eventCount) -> void
+{
+	// Nothing to do if there are no inputs
+	if (_members.empty())
+	{
+		return;
+	}
+
+	// Sort the inputs by bit
+	std::ranges::stable_sort(_members, {}, &Member::_bit);
+
+	// Find the runs of consecutive bits
+	for (std::size_t runStart = 0; runStart < _members.size();)
+	{
+		auto runEnd = runStart + 1;
+		while (runEnd < _members.size() && _members[runEnd]._bit == _members[runEnd - 1]._bit + 1)
+		{
+			++runEnd;
+		}
+
+		_runs.push_back({ ._firstMember = runStart, ._memberCount = runEnd - runStart });
+		runStart = runEnd;
+	}
+
+	// Allocate the buffers for the packed bits
+	_firstByte = _members.front()._bit / 8;
+	const auto byteCount = _members.back()._bit / 8 - _firstByte + 1;
+	_lastBits.resize(byteCount);
+	_flippedBits.resize(byteCount);
+
+	// Attach the values first, so that the values of each run lie next to each other
+	for (auto &&member : _members)
+	{
+		member._state.get().attachValue(dataArray);
+	}
+
+	// Now attach the rest of the data
+	for (auto &&member : _members)
+	{
+		member._input.get().attachInput(dataArray, eventCount);
+	}
+}
+
+auto PackedBitGroup::updateReadStates(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+	const CommonReadState::Changes &commonChanges,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Nothing to do if there are no inputs
+	if (_members.empty())
+	{
+		return;
+	}
+
+	// If the payload is missing some of the bits, update each input on its own, so that the inputs whose bits are
+	// present still get updated
+	if (!payloadOrError || payloadOrError->get().data().size() < _firstByte + _lastBits.size()) [[unlikely]]
+	{
+		for (auto &&member : _members)
+		{
+			const PackedBitReadState state { ._state = member._state, ._bit = member._bit };
+			state.update(writeSentinel, timeStamp, payloadOrError, commonChanges, eventsToRaise);
+		}
+		_lastBitsValid = false;
+		return;
+	}
+
+	const auto data = payloadOrError->get().data();
+
+	// Extract all the bits
+	extractBits(writeSentinel, data);
+
+	// If we don't have the bits of the last read, we must compare each value
+	if (!_lastBitsValid)
+	{
+		for (auto &&member : _members)
+		{
+			member._state.get().commitValue(writeSentinel, timeStamp, commonChanges, eventsToRaise);
+		}
+
+		std::memcpy(_lastBits.data(), data.data() + _firstByte, _lastBits.size());
+		_lastBitsValid = true;
+		return;
+	}
+
+	// Find the bits that have changed, and commit the values accordingly. Only the flipped bits will raise events.
+	const auto anyFlipped = findFlippedBits(data);
+	const auto firstBit = _firstByte * 8;
+	for (auto &&member : _members)
+	{
+		const auto flipped = anyFlipped && testBit(_flippedBits, member._bit - firstBit);
+		member._state.get().commitValue(writeSentinel, timeStamp, flipped, commonChanges, eventsToRaise);
+	}
+}
+
+auto PackedBitGroup::extractBits(WriteSentinel &writeSentinel, std::span<const std::byte> data) -> void
+{
+	for (auto &&run : _runs)
+	{
+		const auto members = std::span(_members).subspan(run._firstMember, run._memberCount);
+
+		// Extract all the bits in one go if the values lie next to each other in the data block, which they always should
+		auto *values = &members.front()._state.get().value(writeSentinel);
+		if (&members.back()._state.get().value(writeSentinel) == values + (members.size() - 1)) [[likely]]
+		{
+			kernels::extractBits(data, members.front()._bit, std::span(values, members.size()));
+		}
+		// Extract the bits one by one otherwise
+		else
+		{
+			for (auto &&member : members)
+			{
+				member._state.get().value(writeSentinel) = testBit(data, member._bit);
+			}
+		}
+	}
+}
+
+auto PackedBitGroup::findFlippedBits(std::span<const std::byte> data) noexcept -> bool
+{
+	const auto *newBits = data.data() + _firstByte;
+	const auto byteCount = _lastBits.size();
+
+	// Compare 64 bits at a time
+	std::uint64_t anyFlipped { 0 };
+	std::size_t offset { 0 };
+	for (; offset + sizeof(std::uint64_t) <= byteCount; offset += sizeof(std::uint64_t))
+	{
+		std::uint64_t newWord;
+		std::uint64_t lastWord;
+		std::memcpy(&newWord, newBits + offset, sizeof(newWord));
+		std::memcpy(&lastWord, _lastBits.data() + offset, sizeof(lastWord));
+
+		const auto flippedWord = newWord ^ lastWord;
+		std::memcpy(_flippedBits.data() + offset, &flippedWord, sizeof(flippedWord));
+		anyFlipped |= flippedWord;
+	}
+	// Compare the remaining bytes one by one
+	for (; offset < byteCount; ++offset)
+	{
+		const auto flippedByte = newBits[offset] ^ _lastBits[offset];
+		_flippedBits[offset] = flippedByte;
+		anyFlipped |= std::to_integer<std::uint64_t>(flippedByte);
+	}
+
+	// Remember the bits for next time
+	std::memcpy(_lastBits.data(), newBits, byteCount);
+
+	return anyFlipped != 0;
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,117 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "AbstractInput.hpp"
+#include "CommonReadState.hpp"
+#include "PackedBit.hpp"
+#include "PerValueReadState.hpp"
+#include "ReadCommand.hpp"
+
+#include <xentara/memory/Array.hpp>
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief All the Boolean inputs of an I/O transaction whose values are bits packed together in the payload of the read command.
+///
+/// The values of inputs with consecutive bits are placed next to each other in the data block, so that the bits can be extracted
+/// all at once using kernels::extractBits(). Changes are detected by comparing the packed bits with those of the last read a whole
+/// word at a time, so that the individual values only need to be looked at if any of the bits in a word have flipped.
+class PackedBitGroup final
+{
+public:
+	/// @brief Adds an input to the group
+	/// @param input The input
+	/// @param state The packed bit read state of the input
+	auto add(AbstractInput &input, const PackedBitReadState &state) -> void;
+
+	/// @brief Checks whether the group contains any inputs
+	auto empty() const noexcept -> bool
+	{
+		return _members.empty();
+	}
+
+	/// @brief Attaches all the inputs in the group to their I/O transaction
+	///
+	/// The values of all the inputs are added to the data array first, in the order of their bits.
+	/// @param dataArray The data array that the attributes should be added to.
+	/// @param eventCount A variable that counts the total number of events than can be raised for a single update.
+	auto attachInputs(memory::Array &dataArray, std::size_t &eventCount) -> void;
+
+	/// @brief Updates the read states of all the inputs and collects the events to send
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param timeStamp The update time stamp
+	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
+	/// containing a read error.
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this list.
+	auto updateReadStates(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		const CommonReadState::Changes &commonChanges,
+		PendingEventList &eventsToRaise) -> void;
+
+	/// @brief Discards the copy of the bits of the last read.
+	///
+	/// This must be called if the inputs were updated individually, rather than using updateReadStates().
+	auto invalidate() noexcept -> void
+	{
+		_lastBitsValid = false;
+	}
+
+private:
+	/// @brief An input in the group
+	struct Member final
+	{
+		/// @brief The input
+		std::reference_wrapper<AbstractInput> _input;
+		/// @brief The read state of the input
+		std::reference_wrapper<PerValueReadState<bool>> _state;
+		/// @brief The number of the bit within the payload of the read command
+		std::size_t _bit;
+	};
+
+	/// @brief A run of members with consecutive bits
+	struct Run final
+	{
+		/// @brief The index of the first member
+		std::size_t _firstMember;
+		/// @brief The number of members
+		std::size_t _memberCount;
+	};
+
+	/// @brief Extracts the bits of all the inputs into the data block
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param data The payload. This must contain the bits of all the inputs.
+	auto extractBits(WriteSentinel &writeSentinel, std::span<const std::byte> data) -> void;
+
+	/// @brief Determines which bits have changed since the last read, and remembers the current bits for the next read
+	/// @param data The payload. This must contain the bits of all the inputs.
+	/// @return Whether any of the bits have changed
+	auto findFlippedBits(std::span<const std::byte> data) noexcept -> bool;
+
+	/// @brief The inputs, sorted by bit
+	std::vector<Member> _members;
+	/// @brief The runs of members with consecutive bits
+	std::vector<Run> _runs;
+
+	/// @brief The first byte of the payload that contains any of the bits
+	std::size_t _firstByte { 0 };
+	/// @brief The bytes of the payload containing the bits of the last read, starting with _firstByte
+	std::vector<std::byte> _lastBits;
+	/// @brief Whether _lastBits is up to date
+	bool _lastBitsValid { false };
+	/// @brief A preallocated buffer for the bits that have changed, starting with _firstByte
+	std::vector<std::byte> _flippedBits;
+};
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,24 @@
+// Copyright (c) embedded ocean GmbH
+#include "PayloadCache.hpp"
+
+#include <cstring>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto PayloadCache::update(std::span<const std::byte> data) -> bool
+{
+	// Compare the data. std::memcmp() is vectorized by all common standard libraries, so this is cheap compared to decoding.
+	if (_valid && data.size() == _data.size() && (data.empty() || std::memcmp(data.data(), _data.data(), data.size()) == 0))
+	{
+		return false;
+	}
+
+	// Cache the new data. This will only allocate memory if the payload is larger than any payload before.
+	_data.assign(data.begin(), data.end());
+	_valid = true;
+
+	return true;
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,101 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A copy of the last payload received by a read command.
+///
+/// This is used to detect whether a payload is identical to the last one, or which parts of it have changed, so that
+/// decoding it can be skipped for all or most of the inputs.
+class PayloadCache final
+{
+public:
+	/// @brief The size of the blocks used by updateBlocks(). This is the size of a cache line on common architectures.
+	static constexpr std::size_t kBlockSize = 64;
+
+	/// @brief Preallocates space for a payload of a certain size
+	/// @param size The expected size of the payload in bytes. Space for larger payloads will be allocated as needed.
+	auto reserve(std::size_t size) -> void
+	{
+		_data.reserve(size);
+	}
+
+	/// @brief Compares a payload with the cached one, and caches the new payload if it is different.
+	/// @param data The raw data of the new payload
+	/// @return true if the payload is different from the last one, or if there was no last payload.
+	auto update(std::span<const std::byte> data) -> bool;
+
+	/// @brief Compares a payload with the cached one block by block, and caches the new payload.
+	/// @param data The raw data of the new payload
+	/// @param function A function that will be called with the index of each block of size kBlockSize that has changed.
+	/// @return true if the payload was compared, or false if there was no last payload of the same size, and the payload
+	/// must be regarded as having changed completely. In the latter case, *function* is not called at all.
+	template <typename Function>
+	auto updateBlocks(std::span<const std::byte> data, Function &&function) -> bool;
+
+	/// @brief Checks whether a payload has been cached
+	auto valid() const noexcept -> bool
+	{
+		return _valid;
+	}
+
+	/// @brief Gets the raw data of the cached payload. This is only meaningful if valid() returns true.
+	auto data() const noexcept -> std::span<const std::byte>
+	{
+		return _data;
+	}
+
+	/// @brief Discards the cached payload.
+	///
+	/// This must be called whenever a read fails, so that the next successful read is never regarded as unchanged.
+	auto invalidate() noexcept -> void
+	{
+		_valid = false;
+	}
+
+private:
+	/// @brief The raw data of the last payload
+	std::vector<std::byte> _data;
+	/// @brief Whether _data contains a valid payload
+	bool _valid { false };
+};
+
+template <typename Function>
+auto PayloadCache::updateBlocks(std::span<const std::byte> data, Function &&function) -> bool
+{
+	// We cannot compare the payloads if they have a different size
+	if (!_valid || data.size() != _data.size())
+	{
+		update(data);
+		return false;
+	}
+
+	// Check the entire payload first, since most payloads will be completely unchanged
+	if (data.empty() || std::memcmp(data.data(), _data.data(), data.size()) == 0)
+	{
+		return true;
+	}
+
+	// Compare the individual blocks
+	for (std::size_t offset = 0, blockIndex = 0; offset < data.size(); offset += kBlockSize, ++blockIndex)
+	{
+		const auto size = std::min(kBlockSize, data.size() - offset);
+		if (std::memcmp(data.data() + offset, _data.data() + offset, size) != 0)
+		{
+			// Cache the new data of this block, and report the change
+			std::memcpy(_data.data() + offset, data.data() + offset, size);
+			function(blockIndex);
+		}
+	}
+
+	return true;
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,60 @@
+// Copyright (c) embedded ocean GmbH
+#include "PayloadRegionIndex.hpp"
+
+#include <algorithm>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto PayloadRegionIndex::build(std::span<const std::optional<PayloadRegion>> regions, std::size_t blockSize) -> void
+{
+	// Determine the number of blocks that contain any data
+	std::size_t blockCount { 0 };
+	for (auto &&region : regions)
+	{
+		if (region && region->_size > 0)
+		{
+			blockCount = std::max(blockCount, (region->_offset + region->_size + blockSize - 1) / blockSize);
+		}
+	}
+
+	// Count the inputs per block. We store the counts offset by one, so we can turn them into start positions later.
+	_blockStarts.assign(blockCount + 1, 0);
+	for (auto &&region : regions)
+	{
+		if (region && region->_size > 0)
+		{
+			const auto firstBlock = region->_offset / blockSize;
+			const auto lastBlock = (region->_offset + region->_size - 1) / blockSize;
+			for (auto blockIndex = firstBlock; blockIndex <= lastBlock; ++blockIndex)
+			{
+				++_blockStarts[blockIndex + 1];
+			}
+		}
+	}
+
+	// Turn the counts into start positions
+	for (std::size_t blockIndex = 1; blockIndex <= blockCount; ++blockIndex)
+	{
+		_blockStarts[blockIndex] += _blockStarts[blockIndex - 1];
+	}
+
+	// Fill in the input indices, using a copy of the start positions as insertion points
+	_inputIndices.resize(_blockStarts.back());
+	auto insertionPoints = _blockStarts;
+	for (std::size_t inputIndex = 0; inputIndex < regions.size(); ++inputIndex)
+	{
+		const auto &region = regions[inputIndex];
+		if (region && region->_size > 0)
+		{
+			const auto firstBlock = region->_offset / blockSize;
+			const auto lastBlock = (region->_offset + region->_size - 1) / blockSize;
+			for (auto blockIndex = firstBlock; blockIndex <= lastBlock; ++blockIndex)
+			{
+				_inputIndices[insertionPoints[blockIndex]++] = inputIndex;
+			}
+		}
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
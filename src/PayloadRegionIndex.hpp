@@ -0,0 +1,61 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief The location of the data of an input within the payload of a read command
+struct PayloadRegion
+{
+	/// @brief The offset of the data in bytes
+	std::size_t _offset { 0 };
+	/// @brief The size of the data in bytes
+	std::size_t _size { 0 };
+};
+
+/// @brief An index that maps blocks of a payload to the inputs whose data lies within these blocks.
+///
+/// This is used to find out which inputs are affected by a change in the payload.
+class PayloadRegionIndex final
+{
+public:
+	/// @brief Builds the index
+	/// @param regions The payload regions of all the inputs, in input order. Inputs with an unknown region are not added
+	/// to the index, and must be treated by the caller as if they had changed on every read.
+	/// @param blockSize The size of the blocks, in bytes
+	auto build(std::span<const std::optional<PayloadRegion>> regions, std::size_t blockSize) -> void;
+
+	/// @brief Calls a function for each input whose data lies within a block
+	/// @param blockIndex The index of the block
+	/// @param function A function that will be called with the index of each affected input
+	template <typename Function>
+	auto forEachInput(std::size_t blockIndex, Function &&function) const -> void
+	{
+		// Ignore blocks that no inputs lie in
+		if (blockIndex + 1 >= _blockStarts.size())
+		{
+			return;
+		}
+
+		for (auto index = _blockStarts[blockIndex]; index < _blockStarts[blockIndex + 1]; ++index)
+		{
+			function(_inputIndices[index]);
+		}
+	}
+
+private:
+	/// @brief The position of the first entry for each block in _inputIndices.
+	///
+	/// This contains an additional element at the end, so that the entries for block *n* always run from
+	/// _blockStarts[n] to _blockStarts[n + 1].
+	std::vector<std::size_t> _blockStarts;
+	/// @brief The indices of the inputs affected by each block, sorted by block
+	std::vector<std::size_t> _inputIndices;
+};
+
+} // namespace xentara::plugins::templateDriver
@@ -2,18 +2,70 @@
 #include "PerValueReadState.hpp"
 
 #include "Attributes.hpp"
+#include "Footprint.hpp"
 
 #include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/utils/tools/Concepts.hpp>
+
+#include <algorithm>
 
 namespace xentara::plugins::templateDriver
 {
 
+namespace
+{
+
+/// @brief Assigns a value to an entry in the data block
+///
+/// Strings are compared first, because with swap-in, the entry usually already contains the same value, and assigning
+/// it again would copy the characters for nothing. If the string does need to be assigned, it is assigned in place, so
+/// that the existing memory is reused if the capacity is sufficient.
+template <std::regular DataType>
+auto assignValue(DataType &target, const DataType &source) -> void
+{
+	if constexpr (utils::tools::StringType<DataType>)
+	{
+		if (target != source)
+		{
+			target = source;
+		}
+	}
+	else
+	{
+		target = source;
+	}
+}
+
+/// @brief Resets an entry in the data block to a default constructed value
+///
+/// Strings are cleared rather than assigned an empty string, so that they keep their memory.
+template <std::regular DataType>
+auto resetValue(DataType &target) -> void
+{
+	if constexpr (utils::tools::StringType<DataType>)
+	{
+		target.clear();
+	}
+	else
+	{
+		target = DataType();
+	}
+}
+
+} // namespace
+
+template <std::regular DataType>
+auto PerValueReadState<DataType>::attributes() noexcept -> std::array<std::reference_wrapper<const model::Attribute>, AttributeCount>
+{
+	// Return all the attributes we support, in the order given by AttributeIndex
+	return { { model::Attribute::kChangeTime } };
+}
+
 template <std::regular DataType>
 auto PerValueReadState<DataType>::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
 {
 	// Handle all the attributes we support
-	return
-		function(model::Attribute::kChangeTime);
+	return std::ranges::any_of(attributes(), [&](const model::Attribute &attribute) { return function(attribute); });
 }
 
 template <std::regular DataType>
@@ -26,11 +78,11 @@ auto PerValueReadState<DataType>::forEachEvent(const model::ForEachEventFunction
 
 template <std::regular DataType>
 auto PerValueReadState<DataType>::makeReadHandle(const DataBlock &dataBlock,
-	const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
+	std::size_t index) const noexcept -> std::optional<data::ReadHandle>
 {
-	// Try each readable attribute
-	if (attribute == model::Attribute::kChangeTime)
+	switch (index)
 	{
+	case ChangeTimeIndex:
 		return dataBlock.member(_stateHandle, &State::_changeTime);
 	}
 
@@ -40,19 +92,31 @@ auto PerValueReadState<DataType>::makeReadHandle(const DataBlock &dataBlock,
 template <std::regular DataType>
 auto PerValueReadState<DataType>::valueReadHandle(const DataBlock &dataBlock) const noexcept -> data::ReadHandle
 {
-	return dataBlock.member(_stateHandle, &State::_value);
+	return dataBlock.member(_valueHandle, &ValueSlot::_value);
 }
 
 template <std::regular DataType>
 auto PerValueReadState<DataType>::attach(memory::Array &dataArray, std::size_t &eventCount) -> void
 {
-	// Add the state to the array
-	_stateHandle = dataArray.appendObject<State>();
+	// Add the value to the array, unless this was already done
+	if (!_valueAttached)
+	{
+		attachValue(dataArray);
+	}
+	// Add the rest of the state to the array
+	_stateHandle = appendObject<State>(dataArray);
 
 	// Add the number of events that can be raised at once, which is just the one event we have.
 	eventCount += 1;
 }
 
+template <std::regular DataType>
+auto PerValueReadState<DataType>::attachValue(memory::Array &dataArray) -> void
+{
+	_valueHandle = appendObject<ValueSlot>(dataArray);
+	_valueAttached = true;
+}
+
 template <std::regular DataType>
 auto PerValueReadState<DataType>::update(
 	WriteSentinel &writeSentinel,
@@ -61,15 +125,59 @@ auto PerValueReadState<DataType>::update(
 	const CommonReadState::Changes &commonChanges,
 	PendingEventList &eventsToRaise) -> void
 {
-	// Get the correct array entry
+	// Set the value, replacing errors with a default constructed value
+	if (valueOrError)
+	{
+		assignValue(writeSentinel[_valueHandle]._value, *valueOrError);
+	}
+	else
+	{
+		resetValue(writeSentinel[_valueHandle]._value);
+	}
+
+	// Detect changes and send events
+	commitValue(writeSentinel, timeStamp, commonChanges, eventsToRaise);
+}
+
+template <std::regular DataType>
+auto PerValueReadState<DataType>::update(
+	WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const DataType &value,
+	const CommonReadState::Changes &commonChanges,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Set the value
+	assignValue(writeSentinel[_valueHandle]._value, value);
+
+	// Detect changes and send events
+	commitValue(writeSentinel, timeStamp, commonChanges, eventsToRaise);
+}
+
+template <std::regular DataType>
+auto PerValueReadState<DataType>::commitValue(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const CommonReadState::Changes &commonChanges,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Detect changes to the value
+	const auto valueChanged = writeSentinel[_valueHandle]._value != writeSentinel.oldValues()[_valueHandle]._value;
+
+	commitValue(writeSentinel, timeStamp, valueChanged, commonChanges, eventsToRaise);
+}
+
+template <std::regular DataType>
+auto PerValueReadState<DataType>::commitValue(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	bool valueChanged,
+	const CommonReadState::Changes &commonChanges,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Get the correct array entries
 	auto &state = writeSentinel[_stateHandle];
 	const auto &oldState = writeSentinel.oldValues()[_stateHandle];
 
-	// Set the value, replacing errors with a default constructed value
-	state._value = valueOrError.value_or(DataType());
-
 	// Detect changes
-	const auto valueChanged = state._value != oldState._value;
 	const auto changed = valueChanged || commonChanges;
 
 	// Update the change time, if necessary. We always need to write the change time, even if it is the same as before,
@@ -83,6 +191,14 @@ auto PerValueReadState<DataType>::update(
 	}
 }
 
+template <std::regular DataType>
+auto PerValueReadState<DataType>::keep(WriteSentinel &writeSentinel) -> void
+{
+	// Just copy the old value and state
+	assignValue(writeSentinel[_valueHandle]._value, writeSentinel.oldValues()[_valueHandle]._value);
+	writeSentinel[_stateHandle] = writeSentinel.oldValues()[_stateHandle];
+}
+
 /// @class xentara::plugins::templateDriver::PerValueReadState
 /// @todo change list of template instantiations to the supported types
 template class PerValueReadState<bool>;
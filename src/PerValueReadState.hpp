@@ -13,11 +13,15 @@
 #include <xentara/process/Event.hpp>
 #include <xentara/utils/eh/expected.hpp>
 
+#include <array>
 #include <chrono>
 #include <concepts>
+#include <functional>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <variant>
 
 namespace xentara::plugins::templateDriver
 {
@@ -29,6 +33,23 @@ template <std::regular DataType>
 class PerValueReadState final
 {
 public:
+	/// @brief The type of the value
+	using Value = DataType;
+
+	/// @brief The positions of the attributes in the list returned by attributes()
+	enum AttributeIndex : std::size_t
+	{
+		/// @brief The position of the change time
+		ChangeTimeIndex,
+		/// @brief The number of attributes
+		AttributeCount
+	};
+
+	/// @brief Gets all the attributes that belong to this state, in the order given by AttributeIndex.
+	///
+	/// This is used by forEachAttribute(), and to build tables that map attributes to the states that handle them.
+	static auto attributes() noexcept -> std::array<std::reference_wrapper<const model::Attribute>, AttributeCount>;
+
 	/// @brief Iterates over all the attributes that belong to this state.
 	/// @param function The function that should be called for each attribute
 	/// @return The return value of the last function call
@@ -46,12 +67,12 @@ public:
 	/// @return The return value of the last function call
 	auto forEachEvent(const model::ForEachEventFunction &function, std::shared_ptr<void> parent) -> bool;
 
-	/// @brief Creates a read-handle for an attribute that belong to this state.
+	/// @brief Creates a read-handle for an attribute that belong to this state, given its position in attributes()
 	/// @note The value attribute is not handled, it must be gotten separately using valueReadHandle().
 	/// @param dataBlock The data block the data is stored in
-	/// @param attribute The attribute to create the handle for
-	/// @return A read handle for the attribute, or std::nullopt if the attribute is unknown (including the value attribute)
-	auto makeReadHandle(const DataBlock &dataBlock, const model::Attribute &attribute) const noexcept
+	/// @param index The position of the attribute in the list returned by attributes()
+	/// @return A read handle for the attribute, or std::nullopt if the index is out of range
+	auto makeReadHandle(const DataBlock &dataBlock, std::size_t index) const noexcept
 		-> std::optional<data::ReadHandle>;
 
 	/// @brief Creates a read-handle for the value attribute
@@ -67,6 +88,21 @@ public:
 	/// event count to preallocate a buffer when collecting the events to raise after an update.
 	auto attach(memory::Array &dataArray, std::size_t &eventCount) -> void;
 
+	/// @brief Adds only the value to the data array
+	///
+	/// This can be called before attach() to place the values of several states next to each other in the data block.
+	/// attach() will then only add the remaining data.
+	/// @param dataArray The data array that the value should be added to.
+	auto attachValue(memory::Array &dataArray) -> void;
+
+	/// @brief Gets the value in the data block
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @return A reference to the new value within the write sentinel
+	auto value(WriteSentinel &writeSentinel) const -> DataType &
+	{
+		return writeSentinel[_valueHandle]._value;
+	}
+
 	/// @brief Updates the data and collects the events to send
 	/// @param writeSentinel A write sentinel for the data block the data is stored in
 	/// @param timeStamp The update time stamp
@@ -82,12 +118,61 @@ public:
 		const CommonReadState::Changes &commonChanges,
 		PendingEventList &eventsToRaise) -> void;
 
+	/// @brief Updates the data with a valid value and collects the events to send
+	///
+	/// This overload avoids copying the value into a temporary std::expected object, which matters for strings.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param timeStamp The update time stamp
+	/// @param value The new value
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this list.
+	auto update(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const DataType &value,
+		const CommonReadState::Changes &commonChanges,
+		PendingEventList &eventsToRaise) -> void;
+
+	/// @brief Carries the data over unchanged from the last update, without raising any events.
+	///
+	/// This is necessary because memory resources use swap-in, so the write sentinel does not necessarily contain the last values.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	auto keep(WriteSentinel &writeSentinel) -> void;
+
+	/// @brief Detects changes to a value that was written to the data block directly, and collects the events to send
+	///
+	/// This is used if the value was decoded into the data block by someone else, e.g. together with other values.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in. The new value must already have been
+	/// written to the location returned by value().
+	/// @param timeStamp The update time stamp
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this list.
+	auto commitValue(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const CommonReadState::Changes &commonChanges,
+		PendingEventList &eventsToRaise) -> void;
+
+	/// @brief Commits a value that was written to the data block directly, if it is already known whether the value changed
+	///
+	/// This is used if the caller can detect changes to several values at once more efficiently than by comparing each value.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in. The new value must already have been
+	/// written to the location returned by value().
+	/// @param timeStamp The update time stamp
+	/// @param valueChanged Whether the value is different from the last one
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this list.
+	auto commitValue(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		bool valueChanged,
+		const CommonReadState::Changes &commonChanges,
+		PendingEventList &eventsToRaise) -> void;
+
 private:
-	/// @brief This structure is used to represent the state inside the memory block
+	/// @brief This structure is used to represent the state other than the value inside the memory block
+	///
+	/// The value is kept in a separate array element, so that the values of several states can be placed
+	/// next to each other.
 	struct State final
 	{
-		/// @brief The current value
-		DataType _value {};
 		/// @brief The change time stamp
 		std::chrono::system_clock::time_point _changeTime { std::chrono::system_clock::time_point::min() };
 	};
@@ -95,10 +180,38 @@ private:
 	/// @brief A summary event that is raised when anything changes
 	process::Event _changedEvent { io::Direction::Input };
 
-	/// @brief The array element that contains the state
+	/// @brief This structure is used to represent the value inside the memory block
+	///
+	/// The value is wrapped in a structure so that a read handle can be created for it like for any other member.
+	/// The structure has the same size as the value itself, so the values of several states still lie next to each other.
+	struct ValueSlot final
+	{
+		/// @brief The current value
+		DataType _value {};
+	};
+
+	/// @brief The array element that contains the value
+	memory::Array::ObjectHandle<ValueSlot> _valueHandle;
+	/// @brief Whether the value was already added to the data array using attachValue()
+	bool _valueAttached { false };
+	/// @brief The array element that contains the rest of the state
 	memory::Array::ObjectHandle<State> _stateHandle;
 };
 
+/// @brief A pointer to a per-value read state whose values can be decoded in bulk, or std::monostate for other values.
+/// @todo change list of types to the supported fixed size types
+using BulkReadState = std::variant<std::monostate,
+	PerValueReadState<std::uint8_t> *,
+	PerValueReadState<std::uint16_t> *,
+	PerValueReadState<std::uint32_t> *,
+	PerValueReadState<std::uint64_t> *,
+	PerValueReadState<std::int8_t> *,
+	PerValueReadState<std::int16_t> *,
+	PerValueReadState<std::int32_t> *,
+	PerValueReadState<std::int64_t> *,
+	PerValueReadState<float> *,
+	PerValueReadState<double> *>;
+
 /// @class xentara::plugins::templateDriver::PerValueReadState
 /// @todo change list of extern template statements to the supported types
 extern template class PerValueReadState<bool>;
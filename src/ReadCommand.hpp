@@ -3,6 +3,11 @@
 
 #include <xentara/utils/tools/Unique.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
 namespace xentara::plugins::templateDriver
 {
 
@@ -15,7 +20,51 @@ public:
 	/// @todo use a suitable class to represent the data
 	class Payload final
 	{
+	public:
+		/// @brief Gets the raw data as received from the device.
+		///
+		/// This is used to detect whether the payload has changed since the last read.
+		auto data() const noexcept -> std::span<const std::byte>
+		{
+			return _data;
+		}
+
+		/// @brief Gets the raw data for modification.
+		///
+		/// This is used by the Simulator to generate simulated data.
+		auto data() noexcept -> std::span<std::byte>
+		{
+			return _data;
+		}
+
+		/// @brief Changes the size of the raw data. New bytes are set to zero.
+		auto resize(std::size_t size) -> void
+		{
+			_data.resize(size);
+		}
+
+		/// @brief Overwrites part of the data with data from a change notification.
+		///
+		/// This is used in subscription mode to keep an image of the data up to date between reads.
+		/// @param offset The offset of the changed data
+		/// @param data The new data
+		/// Data that lies beyond the end of the payload is ignored.
+		auto update(std::size_t offset, std::span<const std::byte> data) -> void
+		{
+			if (offset >= _data.size())
+			{
+				return;
+			}
+
+			const auto count = std::min(data.size(), _data.size() - offset);
+			std::copy_n(data.begin(), count, _data.begin() + offset);
+		}
+
+	private:
+		/// @brief The raw data
+		/// @todo use the data representation of the protocol, if it has one
+		std::vector<std::byte> _data;
 	};
 };
 
-} // namespace xentara::plugins::templateDriver
\ No newline at end of file
+} // namespace xentara::plugins::templateDriver
@@ -45,20 +45,24 @@ public:
 private:
 	/// @brief A reference to the target element
 	std::reference_wrapper<Target> _target;
+	/// @brief Whether a connection was already requested by preparePreOperational()
+	bool _connectRequested { false };
 };
 
 template <typename Target>
 auto ReadTask<Target>::preparePreOperational(const process::ExecutionContext &context) -> Status
 {
-	// Request a connection
-	_target.get().requestConnect(context.scheduledTime());
-
-	// Read the value once to initialize it
-	operational(context);
+	// Request a connection the first time we are called. The connection is established in the background.
+	if (!_connectRequested)
+	{
+		_target.get().requestConnect(context.scheduledTime());
+		_connectRequested = true;
+	}
 
-	// We are done now. Even if we couldn't read the value, we proceed to the next stage,
+	// Read the value once in the background to initialize it, so that the initial reads of all targets run in parallel.
+	// We are done once the initial read has finished. Even if we couldn't read the value, we proceed to the next stage,
 	// because attempting again is unlikely to succeed any better.
-	return Status::Ready;
+	return _target.get().performInitialRead(context) ? Status::Ready : Status::Pending;
 }
 
 template <typename Target>
@@ -0,0 +1,138 @@
+// Copyright (c) embedded ocean GmbH
+#include "ScaledInputGroup.hpp"
+
+#include "ConversionKernels.hpp"
+#include "CustomError.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+#include <algorithm>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto ScaledInputGroup::add(AbstractInput &input, const ScaledReadState &state) -> void
+{
+	_inputs.push_back(input);
+	_states.push_back(state._state);
+	_payloadOffsets.push_back(state._offset);
+	_rawTypes.push_back(state._scaling._rawType);
+	_scales.push_back(state._scaling._scale);
+	_offsets.push_back(state._scaling._offset);
+	_rawValues.push_back(0.0);
+
+	// Add 16-bit signed raw values to a run, so they can be decoded using the conversion kernel
+	if (state._scaling._rawType == RawType::Int16)
+	{
+		const auto index = _states.size() - 1;
+		if (!_int16Runs.empty() && _int16Runs.back()._firstInput + _int16Runs.back()._inputCount == index &&
+			_payloadOffsets[_int16Runs.back()._firstInput] + _int16Runs.back()._inputCount * 2 == state._offset)
+		{
+			++_int16Runs.back()._inputCount;
+		}
+		else
+		{
+			_int16Runs.push_back({ ._firstInput = index, ._inputCount = 1 });
+		}
+		_int16Values.resize(std::max(_int16Values.size(), _int16Runs.back()._inputCount));
+	}
+
+	_requiredPayloadSize = std::max(_requiredPayloadSize, state._offset + rawSize(state._scaling._rawType));
+}
+
+auto ScaledInputGroup::attachInputs(memory::Array &dataArray, std::size_t &eventCount) -> void
+{
+	// Attach the values first, so they lie next to each other
+	for (auto &&state : _states)
+	{
+		state.get().attachValue(dataArray);
+	}
+
+	// Now attach the rest of the data
+	for (auto &&input : _inputs)
+	{
+		input.get().attachInput(dataArray, eventCount);
+	}
+}
+
+auto ScaledInputGroup::updateReadStates(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+	const CommonReadState::Changes &commonChanges,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Nothing to do if there are no scaled inputs
+	if (_states.empty())
+	{
+		return;
+	}
+
+	// If the payload is missing some of the values, update each input on its own, so that the inputs whose values are
+	// present still get updated
+	if (!payloadOrError || payloadOrError->get().data().size() < _requiredPayloadSize) [[unlikely]]
+	{
+		for (std::size_t index = 0; index < _states.size(); ++index)
+		{
+			const ScaledReadState state {
+				._state = _states[index],
+				._offset = _payloadOffsets[index],
+				._scaling = { ._rawType = _rawTypes[index], ._scale = _scales[index], ._offset = _offsets[index] } };
+			state.update(writeSentinel, timeStamp, payloadOrError, commonChanges, eventsToRaise);
+		}
+		return;
+	}
+
+	// Convert all the values
+	scaleValues(writeSentinel, payloadOrError->get().data());
+
+	// Detect changes and collect the events
+	for (auto &&state : _states)
+	{
+		state.get().commitValue(writeSentinel, timeStamp, commonChanges, eventsToRaise);
+	}
+}
+
+auto ScaledInputGroup::scaleValues(WriteSentinel &writeSentinel, std::span<const std::byte> data) -> void
+{
+	// Decode the raw values. 16-bit signed values are decoded below.
+	const auto count = _states.size();
+	for (std::size_t index = 0; index < count; ++index)
+	{
+		if (_rawTypes[index] != RawType::Int16)
+		{
+			_rawValues[index] = decodeRaw(_rawTypes[index], data.data() + _payloadOffsets[index]);
+		}
+	}
+
+	// Decode the 16-bit signed values run by run using the conversion kernel. The kernel is only used to decode the values,
+	// without scaling them, because it works in single precision. Every 16-bit integer is exactly representable as a float.
+	for (auto &&run : _int16Runs)
+	{
+		kernels::scaleBigEndianInt16(data.subspan(_payloadOffsets[run._firstInput], run._inputCount * 2), _int16Values.data(), 1.0f, 0.0f);
+		std::copy_n(_int16Values.data(), run._inputCount, _rawValues.data() + run._firstInput);
+	}
+
+	// Scale all the values in a single pass. The loop has no branches and accesses all the arrays sequentially, so the compiler
+	// will vectorize it.
+	auto *values = &_states.front().get().value(writeSentinel);
+	if (&_states.back().get().value(writeSentinel) == values + (count - 1)) [[likely]]
+	{
+		const auto *rawValues = _rawValues.data();
+		const auto *scales = _scales.data();
+		const auto *offsets = _offsets.data();
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			values[index] = rawValues[index] * scales[index] + offsets[index];
+		}
+	}
+	// Store the values one by one if they are not next to each other
+	else
+	{
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			_states[index].get().value(writeSentinel) = _rawValues[index] * _scales[index] + _offsets[index];
+		}
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,105 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "AbstractInput.hpp"
+#include "CommonReadState.hpp"
+#include "PerValueReadState.hpp"
+#include "ReadCommand.hpp"
+#include "Scaling.hpp"
+
+#include <xentara/memory/Array.hpp>
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief All the inputs of an I/O transaction whose values are scaled from raw values.
+///
+/// The values of all the inputs are converted together in a single pass, rather than one input at a time. The parameters of the
+/// conversion are kept in separate arrays, and the scaled values are placed next to each other in the data block, so that the
+/// compiler can vectorize the conversion. Raw values of type RawType::Int16 that lie next to each other in the payload are
+/// decoded together using kernels::scaleBigEndianInt16().
+class ScaledInputGroup final
+{
+public:
+	/// @brief Adds an input to the group
+	/// @param input The input
+	/// @param state The scaled read state of the input
+	auto add(AbstractInput &input, const ScaledReadState &state) -> void;
+
+	/// @brief Checks whether the group contains any inputs
+	auto empty() const noexcept -> bool
+	{
+		return _inputs.empty();
+	}
+
+	/// @brief Attaches all the inputs in the group to their I/O transaction
+	///
+	/// The values of all the inputs are added to the data array first, so that they lie next to each other.
+	/// @param dataArray The data array that the attributes should be added to.
+	/// @param eventCount A variable that counts the total number of events than can be raised for a single update.
+	auto attachInputs(memory::Array &dataArray, std::size_t &eventCount) -> void;
+
+	/// @brief Updates the read states of all the inputs and collects the events to send
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param timeStamp The update time stamp
+	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
+	/// containing a read error.
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this list.
+	auto updateReadStates(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		const CommonReadState::Changes &commonChanges,
+		PendingEventList &eventsToRaise) -> void;
+
+private:
+	/// @brief A run of inputs whose raw values are of type RawType::Int16, and lie next to each other in the payload
+	struct Int16Run final
+	{
+		/// @brief The index of the first input of the run
+		std::size_t _firstInput { 0 };
+		/// @brief The number of inputs in the run
+		std::size_t _inputCount { 0 };
+	};
+
+	/// @brief Decodes and scales the values of all the inputs into the data block
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param data The payload. This must contain the raw values of all the inputs.
+	auto scaleValues(WriteSentinel &writeSentinel, std::span<const std::byte> data) -> void;
+
+	/// @brief The inputs
+	std::vector<std::reference_wrapper<AbstractInput>> _inputs;
+	/// @brief The read states of the inputs
+	std::vector<std::reference_wrapper<PerValueReadState<double>>> _states;
+
+	/// @brief The offsets of the raw values within the payload of the read command
+	std::vector<std::size_t> _payloadOffsets;
+	/// @brief The types of the raw values
+	std::vector<RawType> _rawTypes;
+	/// @brief The factors the raw values are multiplied with
+	std::vector<double> _scales;
+	/// @brief The offsets added to the values after scaling
+	std::vector<double> _offsets;
+
+	/// @brief A preallocated buffer for the decoded raw values
+	std::vector<double> _rawValues;
+
+	/// @brief The runs of inputs whose raw values are of type RawType::Int16
+	std::vector<Int16Run> _int16Runs;
+	/// @brief A preallocated buffer for the raw values of a single run, large enough for the longest run
+	std::vector<float> _int16Values;
+
+	/// @brief The minimum size of a payload that contains all the raw values
+	std::size_t _requiredPayloadSize { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,91 @@
+// Copyright (c) embedded ocean GmbH
+#include "Scaling.hpp"
+
+#include "ByteOrder.hpp"
+#include "CustomError.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto rawSize(RawType rawType) noexcept -> std::size_t
+{
+	switch (rawType)
+	{
+	case RawType::UInt8:
+	case RawType::Int8:
+		return 1;
+	case RawType::UInt16:
+	case RawType::Int16:
+		return 2;
+	case RawType::UInt32:
+	case RawType::Int32:
+	case RawType::Float32:
+		return 4;
+	case RawType::UInt64:
+	case RawType::Int64:
+	case RawType::Float64:
+		return 8;
+	}
+
+	return 0;
+}
+
+auto decodeRaw(RawType rawType, const std::byte *source) noexcept -> double
+{
+	switch (rawType)
+	{
+	case RawType::UInt8:
+		return double(byteOrder::decode<std::uint8_t>(source));
+	case RawType::UInt16:
+		return double(byteOrder::decode<std::uint16_t>(source));
+	case RawType::UInt32:
+		return double(byteOrder::decode<std::uint32_t>(source));
+	case RawType::UInt64:
+		return double(byteOrder::decode<std::uint64_t>(source));
+	case RawType::Int8:
+		return double(byteOrder::decode<std::int8_t>(source));
+	case RawType::Int16:
+		return double(byteOrder::decode<std::int16_t>(source));
+	case RawType::Int32:
+		return double(byteOrder::decode<std::int32_t>(source));
+	case RawType::Int64:
+		return double(byteOrder::decode<std::int64_t>(source));
+	case RawType::Float32:
+		return double(byteOrder::decode<float>(source));
+	case RawType::Float64:
+		return byteOrder::decode<double>(source);
+	}
+
+	return 0.0;
+}
+
+auto ScaledReadState::update(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+	const CommonReadState::Changes &commonChanges,
+	PendingEventList &eventsToRaise) const -> void
+{
+	// Handle read errors
+	if (!payloadOrError)
+	{
+		_state.get().update(writeSentinel, timeStamp, utils::eh::unexpected(payloadOrError.error()), commonChanges, eventsToRaise);
+		return;
+	}
+
+	// Make sure the payload contains the raw value
+	const auto data = payloadOrError->get().data();
+	const auto size = rawSize(_scaling._rawType);
+	if (_offset > data.size() || data.size() - _offset < size)
+	{
+		_state.get().update(writeSentinel, timeStamp, utils::eh::unexpected(std::error_code(CustomError::PayloadTooShort)), commonChanges, eventsToRaise);
+		return;
+	}
+
+	// Decode and scale the value
+	const auto value = _scaling.apply(decodeRaw(_scaling._rawType, data.data() + _offset));
+	_state.get().update(writeSentinel, timeStamp, value, commonChanges, eventsToRaise);
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,89 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "CommonReadState.hpp"
+#include "PerValueReadState.hpp"
+#include "ReadCommand.hpp"
+
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <system_error>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief The data types that the raw value of a scaled input can have in the payload of a read command
+/// @todo change list of types to the raw types supported by the I/O component
+enum class RawType
+{
+	UInt8,
+	UInt16,
+	UInt32,
+	UInt64,
+	Int8,
+	Int16,
+	Int32,
+	Int64,
+	Float32,
+	Float64
+};
+
+/// @brief Gets the size a raw value occupies in the payload of a read command
+auto rawSize(RawType rawType) noexcept -> std::size_t;
+
+/// @brief Decodes a raw value
+/// @param rawType The type of the raw value
+/// @param source The encoded value. Must contain at least rawSize(rawType) bytes.
+/// @return The raw value, converted to double
+auto decodeRaw(RawType rawType, const std::byte *source) noexcept -> double;
+
+/// @brief A linear conversion from a raw value to an engineering unit
+struct Scaling final
+{
+	/// @brief The type of the raw value
+	RawType _rawType { RawType::Int16 };
+	/// @brief The factor the raw value is multiplied with
+	double _scale { 1.0 };
+	/// @brief The offset that is added to the value after scaling
+	double _offset { 0.0 };
+
+	/// @brief Applies the scaling to a raw value
+	constexpr auto apply(double rawValue) const noexcept -> double
+	{
+		return rawValue * _scale + _offset;
+	}
+};
+
+/// @brief The read state of an input whose value is scaled from a raw value
+struct ScaledReadState final
+{
+	/// @brief The read state the scaled value is stored in
+	std::reference_wrapper<PerValueReadState<double>> _state;
+	/// @brief The offset of the raw value within the payload of the read command
+	std::size_t _offset { 0 };
+	/// @brief The scaling to apply
+	Scaling _scaling;
+
+	/// @brief Decodes and scales the value of this input alone, and collects the events to send
+	///
+	/// This is used if the input is updated on its own rather than together with the other scaled inputs of the I/O transaction.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param timeStamp The update time stamp
+	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
+	/// containing a read error.
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this list.
+	auto update(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		const CommonReadState::Changes &commonChanges,
+		PendingEventList &eventsToRaise) const -> void;
+};
+
+} // namespace xentara::plugins::templateDriver
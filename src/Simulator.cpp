@@ -0,0 +1,280 @@
+// Copyright (c) embedded ocean GmbH
+#include "Simulator.hpp"
+
+#include "CustomError.hpp"
+#include "KeywordTable.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#	include <winerror.h>
+#else
+#	include <errno.h>
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+namespace
+{
+
+/// @brief The patterns for the pattern keywords
+constexpr KeywordTable<Simulator::Pattern, 3> kPatterns { { {
+	{ "constant"sv, Simulator::Pattern::Constant },
+	{ "ramp"sv, Simulator::Pattern::Ramp },
+	{ "randomWalk"sv, Simulator::Pattern::RandomWalk }
+} } };
+
+} // namespace
+
+auto Simulator::parsePattern(std::string_view keyword) noexcept -> std::optional<Pattern>
+{
+	if (const auto pattern = kPatterns.find(keyword))
+	{
+		return *pattern;
+	}
+
+	return std::nullopt;
+}
+
+Simulator::Simulator(const Settings &settings, ResponseFunction responseFunction, NotificationFunction notificationFunction) :
+	_settings(settings),
+	_responseFunction(std::move(responseFunction)),
+	_notificationFunction(std::move(notificationFunction)),
+	_random(std::random_device()()),
+	_thread([this](std::stop_token stopToken) { threadFunction(stopToken); })
+{
+}
+
+Simulator::~Simulator()
+{
+	// Stop the thread. The condition variable wakes up the thread automatically when a stop is requested, and the
+	// std::jthread object will join the thread when it is destroyed.
+	_thread.request_stop();
+}
+
+auto Simulator::connect() -> void
+{
+	respond(false);
+}
+
+auto Simulator::probe() -> void
+{
+	respond(false);
+}
+
+auto Simulator::send(std::uint32_t requestId, ReadCommand::Payload &payload) -> void
+{
+	{
+		std::scoped_lock lock { _mutex };
+
+		// Add the jitter
+		auto latency = _settings._latency;
+		if (_settings._jitter > 0ms)
+		{
+			std::uniform_int_distribution<std::chrono::milliseconds::rep> jitter { -_settings._jitter.count(), _settings._jitter.count() };
+			latency = std::max(latency + std::chrono::milliseconds(jitter(_random)), 0ms);
+		}
+
+		// Queue the request
+		_requests.push_back({ std::chrono::steady_clock::now() + latency, requestId, payload, injectError(true) });
+		std::ranges::push_heap(_requests, dueLater);
+	}
+
+	// Wake up the thread, so it can wait for the new request if it is due earlier than the others
+	_requestQueued.notify_one();
+}
+
+auto Simulator::subscribe(std::uint16_t handlerIndex, ReadCommand::Payload &payload) -> void
+{
+	{
+		std::scoped_lock lock { _mutex };
+
+		// Queue the subscription, which is due once the first notification is
+		_requests.push_back({ std::chrono::steady_clock::now() + _settings._notificationInterval, handlerIndex, payload, {}, true });
+		std::ranges::push_heap(_requests, dueLater);
+	}
+
+	_requestQueued.notify_one();
+}
+
+auto Simulator::cancel() noexcept -> void
+{
+	std::scoped_lock lock { _mutex };
+
+	_requests.clear();
+}
+
+auto Simulator::write(const WriteCommand &) -> void
+{
+	respond(true);
+}
+
+auto Simulator::injectError(bool requestErrors) -> std::error_code
+{
+	// The connection error is one that TemplateIoComponent::isConnectionError() recognizes.
+	if (chance(_settings._connectionErrorProbability))
+	{
+	#ifdef _WIN32
+		return std::error_code(WSAECONNRESET, std::system_category());
+	#else // _WIN32
+		return std::error_code(ECONNRESET, std::system_category());
+	#endif // _WIN32
+	}
+	
+	if (requestErrors && chance(_settings._errorProbability))
+	{
+		return CustomError::SimulatedError;
+	}
+
+	return std::error_code();
+}
+
+auto Simulator::respond(bool requestErrors) -> void
+{
+	std::error_code error;
+	{
+		std::scoped_lock lock { _mutex };
+		error = injectError(requestErrors);
+	}
+
+	// Report the error
+	if (error)
+	{
+		throw std::system_error(error);
+	}
+}
+
+auto Simulator::change(ReadCommand::Payload &payload) -> std::span<const std::byte>
+{
+	// Nothing changes for a constant pattern
+	if (_settings._pattern == Pattern::Constant)
+	{
+		return {};
+	}
+
+	// Change the words, keeping track of the first and last changed byte
+	const auto data = payload.data();
+	std::size_t firstChange = data.size();
+	std::size_t endOfChanges = 0;
+	for (std::size_t offset = 0; offset + 2 <= data.size(); offset += 2)
+	{
+		if (!chance(_settings._changeProbability))
+		{
+			continue;
+		}
+		firstChange = std::min(firstChange, offset);
+		endOfChanges = offset + 2;
+
+		// Get the word
+		auto word = std::uint16_t((std::to_integer<std::uint16_t>(data[offset]) << 8) | std::to_integer<std::uint16_t>(data[offset + 1]));
+
+		// Change the word
+		if (_settings._pattern == Pattern::RandomWalk && chance(0.5))
+		{
+			--word;
+		}
+		else
+		{
+			++word;
+		}
+
+		// Store the word in big-endian byte order
+		data[offset] = std::byte(word >> 8);
+		data[offset + 1] = std::byte(word & 0xff);
+	}
+
+	if (firstChange >= endOfChanges)
+	{
+		return {};
+	}
+	return data.subspan(firstChange, endOfChanges - firstChange);
+}
+
+auto Simulator::threadFunction(std::stop_token stopToken) -> void
+{
+	std::unique_lock lock { _mutex };
+	while (!stopToken.stop_requested())
+	{
+		// Wait for a request
+		if (_requests.empty())
+		{
+			_requestQueued.wait(lock, stopToken, [this] { return !_requests.empty(); });
+			continue;
+		}
+
+		// Wait until the first request is due. Start over if a request that is due earlier is queued in the meantime, or if
+		// the requests are withdrawn.
+		const auto due = _requests.front()._due;
+		if (std::chrono::steady_clock::now() < due)
+		{
+			_requestQueued.wait_until(lock, stopToken, due, [&] { return _requests.empty() || _requests.front()._due < due; });
+			continue;
+		}
+
+		// Take the request
+		std::ranges::pop_heap(_requests, dueLater);
+		const auto request = _requests.back();
+		_requests.pop_back();
+
+		// Subscriptions stay queued until the next notification is due, and the payload is changed in any case
+		if (request._subscription)
+		{
+			_requests.push_back(request);
+			_requests.back()._due += _settings._notificationInterval;
+			std::ranges::push_heap(_requests, dueLater);
+
+			// Deliver the changes without holding the lock
+			const auto changes = change(request._payload);
+			lock.unlock();
+			if (!changes.empty())
+			{
+				const auto offset = std::size_t(changes.data() - request._payload.get().data().data());
+				_notificationFunction(std::chrono::system_clock::now(), std::uint16_t(request._requestId), offset, changes);
+			}
+			lock.lock();
+			continue;
+		}
+
+		// Change the payload, unless an error was injected. The transaction does not touch the payload while the request
+		// is outstanding, so it is safe to change it here.
+		if (!request._error)
+		{
+			change(request._payload);
+		}
+
+		// Deliver the response without holding the lock
+		lock.unlock();
+		const auto timeStamp = std::chrono::system_clock::now();
+		if (request._error)
+		{
+			_responseFunction(timeStamp, request._requestId, utils::eh::unexpected(request._error));
+		}
+		else
+		{
+			_responseFunction(timeStamp, request._requestId, std::cref(request._payload.get()));
+		}
+		lock.lock();
+	}
+}
+
+auto Simulator::chance(double probability) -> bool
+{
+	if (probability <= 0.0)
+	{
+		return false;
+	}
+	if (probability >= 1.0)
+	{
+		return true;
+	}
+
+	return std::bernoulli_distribution(probability)(_random);
+}
+
+} // namespace xentara::plugins::templateDriver
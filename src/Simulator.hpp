@@ -0,0 +1,201 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "ReadCommand.hpp"
+#include "WriteCommand.hpp"
+
+#include <xentara/utils/eh/expected.hpp>
+#include <xentara/utils/tools/Unique.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <stop_token>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A simulated device that can be used instead of the physical device.
+///
+/// The simulator allows the driver to be exercised without any hardware, e.g. for performance tests. The data of a simulated
+/// read consists of 16-bit big-endian words that change according to a configurable pattern. Writes are accepted and discarded.
+/// Errors can be injected with configurable probabilities.
+///
+/// Reads are answered asynchronously, like pipelined requests to the physical device: send() returns immediately, and a
+/// thread of the simulator delivers the response once a configurable latency and jitter have passed. Connecting, probing and
+/// writing complete immediately, so that the simulator never blocks the thread that calls it. Payloads can also be subscribed
+/// to, in which case the same thread changes them at a configurable interval, and pushes the changed data as notifications.
+///
+/// All functions are thread-safe.
+class Simulator final : private utils::tools::Unique
+{
+public:
+	/// @brief The ways the simulated data can change
+	enum class Pattern : std::uint8_t
+	{
+		/// @brief The data never changes
+		Constant,
+		/// @brief Each word counts up by one each time it changes
+		Ramp,
+		/// @brief Each word moves up or down by one at random each time it changes
+		RandomWalk
+	};
+
+	/// @brief The settings of the simulator
+	struct Settings final
+	{
+		/// @brief The way the data changes
+		Pattern _pattern { Pattern::Ramp };
+		/// @brief The probability that a word changes from one read to the next
+		double _changeProbability { 1.0 };
+		/// @brief The time each read takes
+		std::chrono::milliseconds _latency { 0 };
+		/// @brief The maximum time added to or subtracted from the latency at random
+		std::chrono::milliseconds _jitter { 0 };
+		/// @brief The probability that a read or write fails with an error that only affects the request itself
+		double _errorProbability { 0.0 };
+		/// @brief The probability that a request fails with an error that breaks the connection
+		double _connectionErrorProbability { 0.0 };
+		/// @brief The interval at which subscribed payloads change
+		std::chrono::milliseconds _notificationInterval { 100 };
+	};
+
+	/// @brief The function that receives the responses to reads
+	///
+	/// The function is called on the thread of the simulator with the time the response was delivered, the request ID that was
+	/// passed to send(), and either the payload or the injected error.
+	using ResponseFunction = std::function<void(std::chrono::system_clock::time_point,
+		std::uint32_t,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &)>;
+
+	/// @brief The function that receives change notifications for subscribed payloads
+	///
+	/// The function is called on the thread of the simulator with the time of the change, the handler index that was passed
+	/// to subscribe(), the offset of the changed data within the payload, and the changed data.
+	using NotificationFunction =
+		std::function<void(std::chrono::system_clock::time_point, std::uint16_t, std::size_t, std::span<const std::byte>)>;
+
+	/// @brief Looks up a pattern by its keyword
+	/// @param keyword The keyword
+	/// @return The pattern, or std::nullopt if the keyword is not known
+	static auto parsePattern(std::string_view keyword) noexcept -> std::optional<Pattern>;
+
+	/// @brief Constructor
+	/// @param settings The settings
+	/// @param responseFunction The function that receives the responses to reads
+	/// @param notificationFunction The function that receives change notifications
+	Simulator(const Settings &settings, ResponseFunction responseFunction, NotificationFunction notificationFunction);
+
+	/// @brief Destructor
+	~Simulator();
+
+	/// @brief Simulates establishing a connection
+	/// @throw std::system_error if a connection error was injected
+	auto connect() -> void;
+
+	/// @brief Simulates a request that probes the connection
+	/// @throw std::system_error if a connection error was injected
+	auto probe() -> void;
+
+	/// @brief Sends a simulated read request
+	///
+	/// The response is delivered to the response function once the latency has passed. The payload is only accessed by
+	/// the thread of the simulator from now on, so several requests for the same payload may be outstanding at the same time.
+	/// @param requestId The ID to pass to the response function together with the response
+	/// @param payload The payload of the last read. The words in the payload are changed according to the pattern before the
+	/// response is delivered, or left unchanged if an error was injected. The payload must remain valid until the response was
+	/// delivered, or the request was withdrawn using cancel().
+	auto send(std::uint32_t requestId, ReadCommand::Payload &payload) -> void;
+
+	/// @brief Subscribes to changes of a payload
+	///
+	/// The payload is changed according to the pattern at the notification interval, and the changed data is delivered to
+	/// the notification function. The payload is only accessed by the thread of the simulator from now on, so it can also be
+	/// passed to send().
+	/// @param handlerIndex The handler index to pass to the notification function together with the changes
+	/// @param payload The payload. The payload must remain valid until the subscription was withdrawn using cancel().
+	auto subscribe(std::uint16_t handlerIndex, ReadCommand::Payload &payload) -> void;
+
+	/// @brief Withdraws all read requests whose responses have not been delivered yet, and all subscriptions
+	auto cancel() noexcept -> void;
+
+	/// @brief Simulates a write
+	/// @param command The write command. The data is discarded.
+	/// @throw std::system_error if an error was injected
+	auto write(const WriteCommand &command) -> void;
+
+private:
+	/// @brief A read request whose response has not been delivered yet
+	struct Request final
+	{
+		/// @brief The time the response is due
+		std::chrono::steady_clock::time_point _due;
+		/// @brief The request ID, or the handler index for a subscription
+		std::uint32_t _requestId;
+		/// @brief The payload
+		std::reference_wrapper<ReadCommand::Payload> _payload;
+		/// @brief The injected error, if any
+		std::error_code _error;
+		/// @brief Whether this is a subscription, which is due whenever the next notification is
+		bool _subscription { false };
+	};
+
+	/// @brief Orders requests so that the one due first is at the top of a heap
+	static auto dueLater(const Request &left, const Request &right) noexcept -> bool
+	{
+		return left._due > right._due;
+	}
+
+	/// @brief Picks an error to inject, if any. _mutex must be locked.
+	/// @param requestErrors Whether errors that only affect the request itself may be injected
+	/// @return The error, or a default constructed error code if no error is injected
+	auto injectError(bool requestErrors) -> std::error_code;
+
+	/// @brief Throws an injected error, if any
+	/// @param requestErrors Whether errors that only affect the request itself may be injected
+	/// @throw std::system_error if an error was injected
+	auto respond(bool requestErrors) -> void;
+
+	/// @brief Changes the words of a payload according to the pattern. _mutex must be locked.
+	/// @return The part of the payload that has changed, which is empty if nothing changed
+	auto change(ReadCommand::Payload &payload) -> std::span<const std::byte>;
+
+	/// @brief Decides at random whether an event happens. _mutex must be locked.
+	/// @param probability The probability of the event
+	auto chance(double probability) -> bool;
+
+	/// @brief The thread function that delivers the responses
+	auto threadFunction(std::stop_token stopToken) -> void;
+
+	/// @brief The settings
+	Settings _settings;
+	/// @brief The function that receives the responses
+	ResponseFunction _responseFunction;
+	/// @brief The function that receives the notifications
+	NotificationFunction _notificationFunction;
+
+	/// @brief Protects _random and _requests
+	std::mutex _mutex;
+	/// @brief The random number generator
+	std::mt19937 _random;
+	/// @brief The outstanding requests and the subscriptions, as a heap ordered by dueLater(). The vector keeps its capacity, so that requests
+	/// are queued without allocating memory once the simulator has warmed up.
+	std::vector<Request> _requests;
+	/// @brief Notified when a request was queued
+	std::condition_variable_any _requestQueued;
+
+	/// @brief The thread that delivers the responses. This is declared last, so that the thread is stopped before any of
+	/// the other members are destroyed.
+	std::jthread _thread;
+};
+
+} // namespace xentara::plugins::templateDriver
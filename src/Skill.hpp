@@ -5,6 +5,8 @@
 #include "TemplateIoTransaction.hpp"
 #include "TemplateOutput.hpp"
 #include "TemplateInput.hpp"
+#include "StartupPool.hpp"
+#include "WorkerPool.hpp"
 
 #include <xentara/skill/Skill.hpp>
 #include <xentara/utils/core/Uuid.hpp>
@@ -48,6 +50,11 @@ private:
 
 	/// @brief The skill class object
 	static Class _class;
+
+	/// @brief The worker pool shared by all elements of the skill
+	WorkerPool _workerPool;
+	/// @brief The pool used by all elements of the skill to connect and perform the initial reads during startup
+	StartupPool _startupPool;
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,151 @@
+// Copyright (c) embedded ocean GmbH
+#include "StartupPool.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+StartupPool::~StartupPool()
+{
+	// Request all threads to stop. The condition variable wakes up the threads automatically when a stop is requested.
+	for (auto &&thread : _threads)
+	{
+		thread.request_stop();
+	}
+
+	// The std::jthread objects will join the threads when they are destroyed. This includes _stoppedThreads, which
+	// have already been asked to stop.
+}
+
+auto StartupPool::requestConcurrency(std::size_t concurrency) noexcept -> void
+{
+	_concurrency = std::max(_concurrency, concurrency);
+}
+
+auto StartupPool::addParticipant() noexcept -> void
+{
+	std::scoped_lock lock { _mutex };
+
+	++_participantCount;
+}
+
+auto StartupPool::participantFinished() noexcept -> void
+{
+	std::scoped_lock lock { _mutex };
+
+	--_participantCount;
+	stopIfIdle();
+}
+
+auto StartupPool::submit(std::function<void()> job) -> void
+{
+	std::scoped_lock lock { _mutex };
+
+	// Start the threads, if this hasn't been done yet
+	if (_threads.empty())
+	{
+		// Jobs of the same strand never run at the same time, so more threads than strands would never be used
+		const auto concurrency = _concurrency > 0 ? _concurrency : kDefaultConcurrency;
+		const auto threadCount = std::clamp<std::size_t>(_strandCount, 1, concurrency);
+		_threads.reserve(threadCount);
+		for (std::size_t index = 0; index < threadCount; ++index)
+		{
+			_threads.emplace_back([this](std::stop_token stopToken) { workerFunction(stopToken); });
+		}
+	}
+
+	// Queue the job and wake up one of the threads
+	_jobs.push_back(std::move(job));
+	_jobSubmitted.notify_one();
+}
+
+auto StartupPool::Strand::submit(std::function<void()> job) -> void
+{
+	std::unique_lock lock { _mutex };
+
+	// Queue the job. If the jobs of the strand are already being run, the job will be picked up automatically.
+	_jobs.push_back(std::move(job));
+	if (_running)
+	{
+		return;
+	}
+	_running = true;
+	lock.unlock();
+
+	// Have a thread of the pool run the jobs
+	try
+	{
+		_pool.get().submit([this]() noexcept { run(); });
+	}
+	catch (...)
+	{
+		// Withdraw the job. Since no jobs were being run, the queue only contained this one job.
+		lock.lock();
+		_jobs.clear();
+		_running = false;
+		throw;
+	}
+}
+
+auto StartupPool::Strand::run() noexcept -> void
+{
+	std::unique_lock lock { _mutex };
+	while (!_jobs.empty())
+	{
+		// Take the job, and execute it without holding the lock
+		auto job = std::move(_jobs.front());
+		_jobs.pop_front();
+		lock.unlock();
+		job();
+		lock.lock();
+	}
+
+	_running = false;
+}
+
+auto StartupPool::workerFunction(std::stop_token stopToken) -> void
+{
+	std::unique_lock lock { _mutex };
+	while (true)
+	{
+		// Wait for a job
+		if (!_jobSubmitted.wait(lock, stopToken, [this] { return !_jobs.empty(); }))
+		{
+			return;
+		}
+
+		// Take the job, and execute it without holding the lock
+		auto job = std::move(_jobs.front());
+		_jobs.pop_front();
+		lock.unlock();
+		job();
+		lock.lock();
+
+		// Jobs can be submitted without any participants, e.g. a connect requested by a task that does not take part in
+		// the startup, so we need to check here as well whether the threads are still needed.
+		stopIfIdle();
+	}
+}
+
+auto StartupPool::stopIfIdle() noexcept -> void
+{
+	// Keep the threads while they are still needed
+	if (_participantCount > 0 || !_jobs.empty())
+	{
+		return;
+	}
+
+	// Ask the threads to stop. Threads that are still running a job exit once it has finished. We do not wait for them
+	// here, so that the caller is not held up by a slow job, and because the caller may be one of the threads itself.
+	for (auto &&thread : _threads)
+	{
+		thread.request_stop();
+	}
+	std::ranges::move(_threads, std::back_inserter(_stoppedThreads));
+	_threads.clear();
+}
+
+} // namespace xentara::plugins::templateDriver
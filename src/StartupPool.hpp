@@ -0,0 +1,131 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/utils/tools/Unique.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A pool of threads used to connect the I/O components and perform the initial reads concurrently during startup.
+///
+/// Unlike the WorkerPool, this pool runs independent jobs that spend most of their time waiting for the physical devices.
+/// The pool has one thread for each strand, but no more than the concurrency limit, so that a large number of devices
+/// does not open an unbounded number of connections at once. The limit belongs to the pool, and thus to the skill, but is
+/// configured by the elements that use the pool, using requestConcurrency().
+///
+/// The threads are only started when the first job is submitted. Elements that use the pool during startup register as
+/// participants, and the threads are stopped once no participants are left and all queued jobs have been run, so that they
+/// do not stay around for the whole runtime. If another job is submitted after that, new threads are started.
+class StartupPool final : private utils::tools::Unique
+{
+public:
+	/// @brief A sequence of jobs that run one after the other on the threads of a startup pool.
+	///
+	/// Jobs submitted to different strands run at the same time, but the jobs of a single strand never do. This is used
+	/// for jobs that share a connection to a physical device, and must therefore not use it at the same time.
+	class Strand final : private utils::tools::Unique
+	{
+	public:
+		/// @brief Constructor
+		///
+		/// This is not thread-safe, and is intended to be called while the elements of the skill are created.
+		/// @param pool The pool whose threads run the jobs
+		Strand(std::reference_wrapper<StartupPool> pool) noexcept : _pool(pool)
+		{
+			++pool.get()._strandCount;
+		}
+
+		/// @brief Returns the pool whose threads run the jobs
+		auto pool() const noexcept -> StartupPool &
+		{
+			return _pool;
+		}
+
+		/// @brief Submits a job to be executed after all the jobs previously submitted to this strand
+		/// @param job The job. The job must not throw any exceptions.
+		/// @throw std::system_error if the threads of the pool could not be started
+		auto submit(std::function<void()> job) -> void;
+
+	private:
+		/// @brief Runs the queued jobs one after the other until the queue is empty
+		auto run() noexcept -> void;
+
+		/// @brief The pool whose threads run the jobs
+		std::reference_wrapper<StartupPool> _pool;
+
+		/// @brief Protects _jobs and _running
+		std::mutex _mutex;
+		/// @brief The jobs that have not been started yet
+		std::deque<std::function<void()>> _jobs;
+		/// @brief Whether a job of the pool is currently running the jobs of this strand
+		bool _running { false };
+	};
+
+	/// @brief The maximum number of jobs that run at the same time if no element requested a different limit
+	static constexpr std::size_t kDefaultConcurrency = 8;
+
+	/// @brief The destructor stops the threads
+	~StartupPool();
+
+	/// @brief Requests a limit for the number of jobs that run at the same time
+	///
+	/// If several elements request different limits, the largest one is used. This function is not thread-safe, and is
+	/// intended to be called from skill::Element::realize().
+	/// @param concurrency The requested limit. Must not be 0.
+	auto requestConcurrency(std::size_t concurrency) noexcept -> void;
+
+	/// @brief Registers an element that uses the pool during startup
+	///
+	/// Each call to this function must be balanced by a call to participantFinished(). Elements should only register once
+	/// they actually start using the pool, so that elements that never start up, e.g. because their tasks are not scheduled,
+	/// do not keep the threads alive.
+	auto addParticipant() noexcept -> void;
+
+	/// @brief Reports that an element registered with addParticipant() has finished its startup
+	///
+	/// Once all participants have finished, the threads are stopped. Threads that are still running jobs finish all the
+	/// queued jobs first.
+	auto participantFinished() noexcept -> void;
+
+	/// @brief Submits a job to be executed on one of the threads of the pool
+	/// @param job The job. The job must not throw any exceptions.
+	/// @throw std::system_error if the threads could not be started
+	auto submit(std::function<void()> job) -> void;
+
+private:
+	/// @brief The function executed by the threads
+	auto workerFunction(std::stop_token stopToken) -> void;
+
+	/// @brief Stops the threads if there are no participants left and no queued jobs. _mutex must be locked.
+	auto stopIfIdle() noexcept -> void;
+
+	/// @brief The number of strands that use the pool
+	std::size_t _strandCount { 0 };
+	/// @brief The largest limit requested using requestConcurrency(), or 0 if none was requested
+	std::size_t _concurrency { 0 };
+
+	/// @brief Protects _participantCount, _jobs, _threads, and _stoppedThreads
+	std::mutex _mutex;
+	/// @brief The number of participants that have not finished their startup yet
+	std::size_t _participantCount { 0 };
+	/// @brief Used to wake up the threads when a job is submitted
+	std::condition_variable_any _jobSubmitted;
+	/// @brief The jobs that have not been started yet
+	std::deque<std::function<void()>> _jobs;
+
+	/// @brief The threads
+	std::vector<std::jthread> _threads;
+	/// @brief Threads that were asked to stop once all participants had finished. They are joined when the pool is destroyed.
+	std::vector<std::jthread> _stoppedThreads;
+};
+
+} // namespace xentara::plugins::templateDriver
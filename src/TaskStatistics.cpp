@@ -0,0 +1,171 @@
+// Copyright (c) embedded ocean GmbH
+#include "TaskStatistics.hpp"
+
+#include <xentara/memory/memoryResources.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/process/Event.hpp>
+
+#include <algorithm>
+#include <bit>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto TaskStatistics::Histogram::add(std::chrono::microseconds value) noexcept -> void
+{
+	const auto count = std::uint64_t(std::max<std::chrono::microseconds::rep>(value.count(), 0));
+	_buckets[bucketIndex(count)].fetch_add(1, std::memory_order_relaxed);
+}
+
+auto TaskStatistics::Histogram::takePercentile(double percentile) noexcept -> std::chrono::microseconds
+{
+	// Take the counts out of the buckets, leaving them empty for the next interval
+	std::array<std::uint64_t, kBucketCount> counts;
+	std::uint64_t total { 0 };
+	for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket)
+	{
+		counts[bucket] = _buckets[bucket].exchange(0, std::memory_order_relaxed);
+		total += counts[bucket];
+	}
+
+	// Find the bucket that contains the percentile
+	const auto threshold = std::uint64_t(double(total) * percentile);
+	std::uint64_t cumulative { 0 };
+	for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket)
+	{
+		cumulative += counts[bucket];
+		if (cumulative > threshold)
+		{
+			return std::chrono::microseconds(std::int64_t(bucketMidpoint(bucket)));
+		}
+	}
+
+	return std::chrono::microseconds(0);
+}
+
+auto TaskStatistics::Histogram::bucketIndex(std::uint64_t value) noexcept -> std::size_t
+{
+	// Small values have a bucket of their own
+	if (value < kSubBucketCount)
+	{
+		return std::size_t(value);
+	}
+
+	// Use the power of two to select a group of buckets, and the bits after the leading one to select a bucket within the group
+	const auto shift = std::size_t(std::bit_width(value)) - 1 - kSubBucketBits;
+	const auto bucket = (shift + 1) * kSubBucketCount + std::size_t(value >> shift) - kSubBucketCount;
+	return std::min(bucket, kBucketCount - 1);
+}
+
+auto TaskStatistics::Histogram::bucketMidpoint(std::size_t bucket) noexcept -> std::uint64_t
+{
+	// Small values have a bucket of their own
+	if (bucket < kSubBucketCount)
+	{
+		return bucket;
+	}
+
+	// Reverse the calculation in bucketIndex()
+	const auto shift = bucket / kSubBucketCount - 1;
+	const auto lowerBound = std::uint64_t(kSubBucketCount + bucket % kSubBucketCount) << shift;
+	return lowerBound + (std::uint64_t(1) << shift) / 2;
+}
+
+auto TaskStatistics::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
+{
+	return
+		function(_attributes._latency) ||
+		function(_attributes._maximumLatency) ||
+		function(_attributes._duration) ||
+		function(_attributes._maximumDuration) ||
+		function(_attributes._overruns);
+}
+
+auto TaskStatistics::makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
+{
+	if (attribute == _attributes._latency)
+	{
+		return _dataBlock.member(&State::_latency);
+	}
+	else if (attribute == _attributes._maximumLatency)
+	{
+		return _dataBlock.member(&State::_maximumLatency);
+	}
+	else if (attribute == _attributes._duration)
+	{
+		return _dataBlock.member(&State::_duration);
+	}
+	else if (attribute == _attributes._maximumDuration)
+	{
+		return _dataBlock.member(&State::_maximumDuration);
+	}
+	else if (attribute == _attributes._overruns)
+	{
+		return _dataBlock.member(&State::_overruns);
+	}
+
+	return std::nullopt;
+}
+
+auto TaskStatistics::realize() -> void
+{
+	// Create the data block
+	_dataBlock.create(memory::memoryResources::data());
+
+	// Publish the initial values
+	publish(std::chrono::system_clock::now());
+}
+
+auto TaskStatistics::record(std::chrono::system_clock::time_point timeStamp,
+	std::chrono::system_clock::duration latency,
+	std::chrono::steady_clock::duration duration) -> void
+{
+	const auto latencyMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+	const auto durationMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+
+	// Add the values to the statistics
+	_latencies.add(latencyMicroseconds);
+	_durations.add(durationMicroseconds);
+	updateMaximum(_maximumLatency, latencyMicroseconds.count());
+	updateMaximum(_maximumDuration, durationMicroseconds.count());
+	if (_budget > std::chrono::microseconds::zero() && durationMicroseconds > _budget)
+	{
+		_overruns.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Publish the statistics if it is time. Only the thread that succeeds in moving the publish time forward publishes.
+	auto nextPublishTime = _nextPublishTime.load(std::memory_order_relaxed);
+	if (timeStamp.time_since_epoch().count() < nextPublishTime)
+	{
+		return;
+	}
+	const auto newPublishTime = (timeStamp + kPublishInterval).time_since_epoch().count();
+	if (_nextPublishTime.compare_exchange_strong(nextPublishTime, newPublishTime, std::memory_order_relaxed))
+	{
+		publish(timeStamp);
+	}
+}
+
+auto TaskStatistics::publish(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	memory::WriteSentinel sentinel { _dataBlock };
+	auto &state = *sentinel;
+
+	state._latency = _latencies.takePercentile(0.99).count();
+	state._maximumLatency = _maximumLatency.load(std::memory_order_relaxed);
+	state._duration = _durations.takePercentile(0.99).count();
+	state._maximumDuration = _maximumDuration.load(std::memory_order_relaxed);
+	state._overruns = _overruns.load(std::memory_order_relaxed);
+
+	sentinel.commit(timeStamp, process::StaticEventList<1> {});
+}
+
+auto TaskStatistics::updateMaximum(std::atomic<std::int64_t> &maximum, std::int64_t value) noexcept -> void
+{
+	auto current = maximum.load(std::memory_order_relaxed);
+	while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
@@ -0,0 +1,183 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/ObjectBlock.hpp>
+#include <xentara/model/Attribute.hpp>
+#include <xentara/model/ForEachAttributeFunction.hpp>
+#include <xentara/process/ExecutionContext.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Timing statistics for a Xentara task.
+///
+/// This class measures how long after its scheduled time each call to a task starts (the latency), and how long the call takes
+/// (the duration). The measurements are collected in histograms, and published as Xentara attributes once per second. The
+/// histograms are emptied each time they are published, so the percentiles only cover the calls of the last interval.
+///
+/// The histograms and counters are lock-free, so that measurements can be taken from any thread.
+class TaskStatistics final
+{
+public:
+	/// @brief The attributes the statistics are published as
+	struct Attributes final
+	{
+		/// @brief The attribute for the 99th percentile of the latency
+		std::reference_wrapper<const model::Attribute> _latency;
+		/// @brief The attribute for the maximum latency
+		std::reference_wrapper<const model::Attribute> _maximumLatency;
+		/// @brief The attribute for the 99th percentile of the duration
+		std::reference_wrapper<const model::Attribute> _duration;
+		/// @brief The attribute for the maximum duration
+		std::reference_wrapper<const model::Attribute> _maximumDuration;
+		/// @brief The attribute for the number of overruns
+		std::reference_wrapper<const model::Attribute> _overruns;
+	};
+
+	/// @brief Constructor
+	/// @param attributes The attributes to publish the statistics as
+	TaskStatistics(const Attributes &attributes) noexcept : _attributes(attributes)
+	{
+	}
+
+	/// @brief Sets the budget for a single call.
+	///
+	/// Calls that take longer than the budget are counted as overruns. This must be called before the tasks are started.
+	/// @param budget The budget, or 0 if overruns should not be counted.
+	auto setBudget(std::chrono::microseconds budget) noexcept -> void
+	{
+		_budget = budget;
+	}
+
+	/// @brief Iterates over all the attributes
+	/// @param function The function that should be called for each attribute
+	/// @return The return value of the last function call
+	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool;
+
+	/// @brief Creates a read-handle for one of the attributes
+	/// @param attribute The attribute to create the handle for
+	/// @return A read handle for the attribute, or std::nullopt if the attribute is not one of ours
+	auto makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>;
+
+	/// @brief Creates the data block and publishes the initial values
+	///
+	/// This must be called from skill::Element::realize().
+	auto realize() -> void;
+
+	/// @brief Calls a task function, and measures it
+	/// @param context The execution context of the task
+	/// @param function The function to call
+	template <std::invocable Function>
+	auto measure(const process::ExecutionContext &context, Function &&function) -> void
+	{
+		const auto startTime = std::chrono::system_clock::now();
+		const auto startTick = std::chrono::steady_clock::now();
+
+		std::invoke(std::forward<Function>(function));
+
+		const auto duration = std::chrono::steady_clock::now() - startTick;
+		record(startTime, startTime - context.scheduledTime(), duration);
+	}
+
+private:
+	/// @brief A lock-free histogram of durations, with log-linear buckets
+	class Histogram final
+	{
+	public:
+		/// @brief Adds a value to the histogram
+		auto add(std::chrono::microseconds value) noexcept -> void;
+
+		/// @brief Gets a percentile of the values added since the last call, and empties the histogram
+		///
+		/// Values that are added while this function is running are either counted in this call, or in the next one.
+		/// @param percentile The percentile, as a fraction between 0 and 1
+		/// @return The midpoint of the bucket that contains the percentile, which is within 12.5% of the actual value,
+		/// or 0 if no values were added.
+		auto takePercentile(double percentile) noexcept -> std::chrono::microseconds;
+
+	private:
+		/// @brief The number of bits of each value that are used to select a bucket within its power of two
+		static constexpr std::size_t kSubBucketBits = 2;
+		/// @brief The number of buckets each power of two is split into
+		static constexpr std::size_t kSubBucketCount = std::size_t(1) << kSubBucketBits;
+		/// @brief The number of buckets
+		///
+		/// Values below kSubBucketCount µs have a bucket of their own. Each larger power of two is split into kSubBucketCount
+		/// buckets of equal width, so the width of a bucket is at most a quarter of its lower bound. The last bucket also
+		/// contains all values of 2<sup>34</sup> µs and more.
+		static constexpr std::size_t kBucketCount = kSubBucketCount * 33;
+
+		/// @brief Gets the index of the bucket a value belongs in
+		static auto bucketIndex(std::uint64_t value) noexcept -> std::size_t;
+
+		/// @brief Gets the midpoint of a bucket
+		static auto bucketMidpoint(std::size_t bucket) noexcept -> std::uint64_t;
+
+		/// @brief The number of values in each bucket
+		std::array<std::atomic<std::uint64_t>, kBucketCount> _buckets {};
+	};
+
+	/// @brief This structure is used to represent the published statistics inside the memory block
+	struct State final
+	{
+		/// @brief The 99th percentile of the latency, in microseconds
+		std::int64_t _latency { 0 };
+		/// @brief The maximum latency, in microseconds
+		std::int64_t _maximumLatency { 0 };
+		/// @brief The 99th percentile of the duration, in microseconds
+		std::int64_t _duration { 0 };
+		/// @brief The maximum duration, in microseconds
+		std::int64_t _maximumDuration { 0 };
+		/// @brief The number of overruns
+		std::uint64_t _overruns { 0 };
+	};
+
+	/// @brief The interval at which the statistics are published
+	static constexpr std::chrono::seconds kPublishInterval { 1 };
+
+	/// @brief Records a measurement, and publishes the statistics if necessary
+	auto record(std::chrono::system_clock::time_point timeStamp,
+		std::chrono::system_clock::duration latency,
+		std::chrono::steady_clock::duration duration) -> void;
+
+	/// @brief Publishes the statistics, and empties the histograms for the next interval
+	auto publish(std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief Updates an atomic maximum
+	static auto updateMaximum(std::atomic<std::int64_t> &maximum, std::int64_t value) noexcept -> void;
+
+	/// @brief The attributes
+	Attributes _attributes;
+
+	/// @brief The budget for a single call, or 0 if overruns should not be counted
+	std::chrono::microseconds _budget { 0 };
+
+	/// @brief The latencies
+	Histogram _latencies;
+	/// @brief The durations
+	Histogram _durations;
+	/// @brief The maximum latency, in microseconds
+	std::atomic<std::int64_t> _maximumLatency { 0 };
+	/// @brief The maximum duration, in microseconds
+	std::atomic<std::int64_t> _maximumDuration { 0 };
+	/// @brief The number of overruns
+	std::atomic<std::uint64_t> _overruns { 0 };
+
+	/// @brief The time the statistics should be published next, as a count of the ticks of std::chrono::system_clock
+	std::atomic<std::chrono::system_clock::rep> _nextPublishTime { 0 };
+
+	/// @brief The data block that publishes the statistics
+	memory::ObjectBlock<State> _dataBlock;
+};
+
+} // namespace xentara::plugins::templateDriver
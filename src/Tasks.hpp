@@ -11,5 +11,7 @@ namespace xentara::plugins::templateDriver::tasks
 extern const process::Task::Role kRead;
 /// @brief A Xentara task used to write the data points attached to an I/O transaction
 extern const process::Task::Role kWrite;
+/// @brief A Xentara task used to probe the connection to an I/O component
+extern const process::Task::Role kKeepAlive;
 
 } // namespace xentara::plugins::templateDriver::tasks
\ No newline at end of file
@@ -2,7 +2,9 @@
 #include "TemplateInput.hpp"
 
 #include "AbstractTemplateInputHandler.hpp"
+#include "KeywordTable.hpp"
 #include "TemplateInputHandler.hpp"
+#include "TemplateIoComponent.hpp"
 #include "TemplateIoTransaction.hpp"
 
 #include <xentara/config/Context.hpp>
@@ -15,15 +17,74 @@
 #include <xentara/utils/json/decoder/Object.hpp>
 #include <xentara/utils/json/decoder/Errors.hpp>
 
+#include <variant>
+
 namespace xentara::plugins::templateDriver
 {
 	
 using namespace std::literals;
 
+namespace
+{
+
+/// @brief A function that creates a handler for a specific data type
+using HandlerFactory = auto (*)(HandlerArena &arena) -> HandlerArena::Pointer<AbstractTemplateInputHandler>;
+
+/// @brief Creates a handler for a specific data type
+template <typename ValueType>
+auto makeHandler(HandlerArena &arena) -> HandlerArena::Pointer<AbstractTemplateInputHandler>
+{
+	return arena.make<TemplateInputHandler<ValueType>>();
+}
+
+/// @brief The handler factories for the data type keywords
+/// @todo use keywords that are appropriate to the I/O component
+/// @note Xentara data points only support scalar data types, so array keywords like "float32[1024]" cannot be offered here.
+/// Large sample buffers should be modelled as individual inputs in a single I/O transaction with the option "bulkDecode"
+/// enabled instead. Their values are then stored and decoded contiguously, just like the elements of an array would be.
+constexpr KeywordTable<HandlerFactory, 12> kHandlerFactories { { {
+	{ "bool"sv, &makeHandler<bool> },
+	{ "uint8"sv, &makeHandler<std::uint8_t> },
+	{ "uint16"sv, &makeHandler<std::uint16_t> },
+	{ "uint32"sv, &makeHandler<std::uint32_t> },
+	{ "uint64"sv, &makeHandler<std::uint64_t> },
+	{ "int8"sv, &makeHandler<std::int8_t> },
+	{ "int16"sv, &makeHandler<std::int16_t> },
+	{ "int32"sv, &makeHandler<std::int32_t> },
+	{ "int64"sv, &makeHandler<std::int64_t> },
+	{ "float32"sv, &makeHandler<float> },
+	{ "float64"sv, &makeHandler<double> },
+	{ "string"sv, &makeHandler<std::string> }
+} } };
+
+/// @brief The raw types for the raw type keywords
+/// @todo use keywords that are appropriate to the I/O component
+constexpr KeywordTable<RawType, 10> kRawTypes { { {
+	{ "uint8"sv, RawType::UInt8 },
+	{ "uint16"sv, RawType::UInt16 },
+	{ "uint32"sv, RawType::UInt32 },
+	{ "uint64"sv, RawType::UInt64 },
+	{ "int8"sv, RawType::Int8 },
+	{ "int16"sv, RawType::Int16 },
+	{ "int32"sv, RawType::Int32 },
+	{ "int64"sv, RawType::Int64 },
+	{ "float32"sv, RawType::Float32 },
+	{ "float64"sv, RawType::Float64 }
+} } };
+
+} // namespace
+
 auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void
 {
+	// The handler is allocated from the arena of the I/O component, so that the handlers of data points that are loaded
+	// one after the other lie next to each other in memory
+	_handlerArena = _ioComponent.get().handlerArena();
+
 	// Go through all the members of the JSON object that represents this object
 	bool ioTransactionLoaded = false;
+	std::optional<RawType> rawType;
+	bool scaleLoaded = false;
+	Scaling scaling;
 	for (auto && [name, value] : jsonObject)
     {
 		if (name == "dataType"sv)
@@ -41,6 +102,28 @@ auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Conte
 				});
 			ioTransactionLoaded = true;
 		}
+		else if (name == "offset"sv)
+		{
+			_offset = value.asNumber<std::size_t>();
+		}
+		else if (name == "bitOffset"sv)
+		{
+			_bitOffset = value.asNumber<std::size_t>();
+		}
+		else if (name == "rawType"sv)
+		{
+			rawType = parseRawType(value);
+		}
+		else if (name == "scale"sv)
+		{
+			scaling._scale = value.asNumber<double>();
+			scaleLoaded = true;
+		}
+		else if (name == "scaleOffset"sv)
+		{
+			scaling._offset = value.asNumber<double>();
+			scaleLoaded = true;
+		}
 		/// @todo load custom configuration parameters
 		else if (name == "TODO"sv)
 		{
@@ -74,6 +157,52 @@ auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Conte
 		/// @todo replace "I/O transaction" and "template input" with more descriptive names
 		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("missing I/O transaction in template input"));
 	}
+	// Check the bit offset
+	if (_bitOffset)
+	{
+		// The bit is extracted together with the other packed bits, so we need to know where it is
+		if (!_offset)
+		{
+			/// @todo replace "template input" with a more descriptive name
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("bit offset specified for template input without offset"));
+		}
+		// Only Boolean values can be packed
+		if (!_handler->booleanReadState())
+		{
+			/// @todo replace "template input" with a more descriptive name
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("bit offset specified for non-Boolean template input"));
+		}
+		// A value cannot be a packed bit and a scaled value at the same time
+		if (rawType)
+		{
+			/// @todo replace "template input" with a more descriptive name
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("both bit offset and raw type specified for template input"));
+		}
+	}
+	// Check the scaling parameters
+	if (rawType)
+	{
+		// The raw value is decoded together with those of the other scaled inputs, so we need to know where it is
+		if (!_offset)
+		{
+			/// @todo replace "template input" with a more descriptive name
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("scaled template input has no offset"));
+		}
+		// The scaled value is always a 64 bit floating point value
+		if (!std::holds_alternative<PerValueReadState<double> *>(_handler->bulkReadState()))
+		{
+			/// @todo replace "template input" with a more descriptive name
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("scaled template input must have data type float64"));
+		}
+
+		scaling._rawType = *rawType;
+		_scaling = scaling;
+	}
+	else if (scaleLoaded)
+	{
+		/// @todo replace "template input" with a more descriptive name
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("scale or scale offset specified for template input without raw type"));
+	}
 	/// @todo perform consistency and completeness checks
 	if (!"TODO")
 	{
@@ -82,87 +211,136 @@ auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Conte
 	}
 }
 
-auto TemplateInput::createHandler(utils::json::decoder::Value &value) -> std::unique_ptr<AbstractTemplateInputHandler>
+auto TemplateInput::createHandler(utils::json::decoder::Value &value) -> HandlerArena::Pointer<AbstractTemplateInputHandler>
 {
 	// Get the keyword from the value
 	auto keyword = value.asString<std::string>();
-	
-	/// @todo use keywords that are appropriate to the I/O component
-	if (keyword == "bool"sv)
-	{
-		return std::make_unique<TemplateInputHandler<bool>>();
-	}
-	else if (keyword == "uint8"sv)
+
+	// Look up the keyword
+	const auto factory = kHandlerFactories.find(keyword);
+	if (!factory)
 	{
-		return std::make_unique<TemplateInputHandler<std::uint8_t>>();
+		/// @todo replace "template input" with a more descriptive name
+		utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown data type in template input"));
 	}
-	else if (keyword == "uint16"sv)
+
+	return (*factory)(*_handlerArena);
+}
+
+auto TemplateInput::parseRawType(utils::json::decoder::Value &value) -> RawType
+{
+	// Get the keyword from the value
+	auto keyword = value.asString<std::string>();
+
+	// Look up the keyword
+	const auto rawType = kRawTypes.find(keyword);
+	if (!rawType)
 	{
-		return std::make_unique<TemplateInputHandler<std::uint16_t>>();
+		/// @todo replace "template input" with a more descriptive name
+		utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown raw type in template input"));
 	}
-	else if (keyword == "uint32"sv)
+
+	return *rawType;
+}
+
+auto TemplateInput::dataType() const -> const data::DataType &
+{
+	// dataType() must not be called before the configuration was loaded, so the handler should have been
+	// created already.
+	if (!_handler) [[unlikely]]
 	{
-		return std::make_unique<TemplateInputHandler<std::uint32_t>>();
+		throw std::logic_error("internal error: xentara::plugins::templateDriver::TemplateInput::dataType() called before configuration has been loaded");
 	}
-	else if (keyword == "uint64"sv)
+
+	// Forward the request to the handler
+	return _handler->dataType();
+}
+
+auto TemplateInput::directions() const -> io::Directions
+{
+	return io::Direction::Input;
+}
+
+auto TemplateInput::payloadRegion() const noexcept -> std::optional<PayloadRegion>
+{
+	// We need both the offset and the size
+	if (!_offset || !_handler)
 	{
-		return std::make_unique<TemplateInputHandler<std::uint64_t>>();
+		return std::nullopt;
 	}
-	else if (keyword == "int8"sv)
+	// Packed bits only occupy the byte that contains the bit
+	if (_bitOffset)
 	{
-		return std::make_unique<TemplateInputHandler<std::int8_t>>();
+		return PayloadRegion { ._offset = *_offset + *_bitOffset / 8, ._size = 1 };
 	}
-	else if (keyword == "int16"sv)
+	// Scaled inputs use the size of the raw value
+	if (_scaling)
 	{
-		return std::make_unique<TemplateInputHandler<std::int16_t>>();
+		return PayloadRegion { ._offset = *_offset, ._size = rawSize(_scaling->_rawType) };
 	}
-	else if (keyword == "int32"sv)
+	const auto size = _handler->encodedSize();
+	if (!size)
 	{
-		return std::make_unique<TemplateInputHandler<std::int32_t>>();
+		return std::nullopt;
 	}
-	else if (keyword == "int64"sv)
+
+	return PayloadRegion { ._offset = *_offset, ._size = *size };
+}
+
+auto TemplateInput::bulkReadState() noexcept -> BulkReadState
+{
+	// Scaled values cannot be decoded in bulk, because they must be decoded from the raw value
+	if (!_handler || _scaling)
 	{
-		return std::make_unique<TemplateInputHandler<std::int64_t>>();
+		return std::monostate {};
 	}
-	else if (keyword == "float32"sv)
+
+	return _handler->bulkReadState();
+}
+
+auto TemplateInput::scaledReadState() noexcept -> std::optional<ScaledReadState>
+{
+	if (!_handler || !_scaling)
 	{
-		return std::make_unique<TemplateInputHandler<float>>();
+		return std::nullopt;
 	}
-	else if (keyword == "float64"sv)
+
+	// The data type was checked when the configuration was loaded, so this should never fail
+	const auto bulkState = _handler->bulkReadState();
+	const auto state = std::get_if<PerValueReadState<double> *>(&bulkState);
+	if (!state) [[unlikely]]
 	{
-		return std::make_unique<TemplateInputHandler<double>>();
+		return std::nullopt;
 	}
-	else if (keyword == "string"sv)
+
+	return ScaledReadState { ._state = **state, ._offset = _offset.value_or(0), ._scaling = *_scaling };
+}
+
+auto TemplateInput::packedBitReadState() noexcept -> std::optional<PackedBitReadState>
+{
+	if (!_handler || !_bitOffset)
 	{
-		return std::make_unique<TemplateInputHandler<std::string>>();
+		return std::nullopt;
 	}
 
-	// The keyword is not known
-	else
+	// The data type was checked when the configuration was loaded, so this should never fail
+	const auto state = _handler->booleanReadState();
+	if (!state) [[unlikely]]
 	{
-		/// @todo replace "template input" with a more descriptive name
-		utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown data type in template input"));
+		return std::nullopt;
 	}
 
-	return std::unique_ptr<AbstractTemplateInputHandler>();
+	return PackedBitReadState { ._state = *state, ._bit = _offset.value_or(0) * 8 + *_bitOffset };
 }
 
-auto TemplateInput::dataType() const -> const data::DataType &
+auto TemplateInput::handlerFootprint() const noexcept -> Footprint
 {
-	// dataType() must not be called before the configuration was loaded, so the handler should have been
-	// created already.
-	if (!_handler) [[unlikely]]
+	if (!_handler)
 	{
-		throw std::logic_error("internal error: xentara::plugins::templateDriver::TemplateInput::dataType() called before configuration has been loaded");
+		return {};
 	}
 
-	// Forward the request to the handler
-	return _handler->dataType();
-}
-
-auto TemplateInput::directions() const -> io::Directions
-{
-	return io::Direction::Input;
+	return _handler->footprint();
 }
 
 auto TemplateInput::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
@@ -263,8 +441,34 @@ auto TemplateInput::updateReadState(WriteSentinel &writeSentinel,
 		throw std::logic_error("internal error: xentara::plugins::templateDriver::TemplateInput::updateReadState() called before configuration has been loaded");
 	}
 
+	// Packed bits are extracted from the payload directly
+	if (auto packedBitState = packedBitReadState())
+	{
+		packedBitState->update(writeSentinel, timeStamp, payloadOrError, commonChanges, eventsToRaise);
+		return;
+	}
+	// Scaled values are decoded from the raw value
+	if (auto scaledState = scaledReadState())
+	{
+		scaledState->update(writeSentinel, timeStamp, payloadOrError, commonChanges, eventsToRaise);
+		return;
+	}
+
+	// Forward the request to the handler
+	_handler->updateReadState(writeSentinel, timeStamp, payloadOrError, _offset, commonChanges, eventsToRaise);
+}
+
+auto TemplateInput::keepReadState(WriteSentinel &writeSentinel) -> void
+{
+	// keepReadState() must not be called before the configuration was loaded, so the handler should have been
+	// created already.
+	if (!_handler) [[unlikely]]
+	{
+		throw std::logic_error("internal error: xentara::plugins::templateDriver::TemplateInput::keepReadState() called before configuration has been loaded");
+	}
+
 	// Forward the request to the handler
-	_handler->updateReadState(writeSentinel, timeStamp, payloadOrError, commonChanges, eventsToRaise);
+	_handler->keepReadState(writeSentinel);
 }
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -3,12 +3,15 @@
 
 #include "AbstractInput.hpp"
 #include "AbstractTemplateInputHandler.hpp"
+#include "HandlerArena.hpp"
 
 #include <xentara/skill/DataPoint.hpp>
 #include <xentara/skill/EnableSharedFromThis.hpp>
 #include <xentara/utils/json/decoder/Value.hpp>
 
 #include <functional>
+#include <memory>
+#include <optional>
 #include <string_view>
 
 namespace xentara::plugins::templateDriver
@@ -58,6 +61,16 @@ public:
 	{
 		return _ioComponent;
 	}
+
+	auto payloadRegion() const noexcept -> std::optional<PayloadRegion> final;
+
+	auto bulkReadState() noexcept -> BulkReadState final;
+
+	auto scaledReadState() noexcept -> std::optional<ScaledReadState> final;
+
+	auto packedBitReadState() noexcept -> std::optional<PackedBitReadState> final;
+
+	auto handlerFootprint() const noexcept -> Footprint final;
 	
 	auto attachInput(memory::Array &dataArray, std::size_t &eventCount) -> void final;
 
@@ -66,12 +79,17 @@ public:
 		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
 		const CommonReadState::Changes &commonChanges,
 		PendingEventList &eventsToRaise) -> void final;
+
+	auto keepReadState(WriteSentinel &writeSentinel) -> void final;
 		
 	/// @}
 
 private:
 	/// @brief Creates an input handler based on a configuration value
-	auto createHandler(utils::json::decoder::Value &value) -> std::unique_ptr<AbstractTemplateInputHandler>;
+	auto createHandler(utils::json::decoder::Value &value) -> HandlerArena::Pointer<AbstractTemplateInputHandler>;
+
+	/// @brief Parses the raw type of a scaled input from a configuration value
+	auto parseRawType(utils::json::decoder::Value &value) -> RawType;
 
 	/// @name Virtual Overrides for skill::DataPoint
 	/// @{
@@ -88,11 +106,24 @@ private:
 	/// @todo give this a more descriptive name, e.g. "_poll"
 	TemplateIoTransaction *_ioTransaction { nullptr };
 
+	/// @brief The arena the handler is allocated from. This must be declared before _handler, so that it is destroyed after it.
+	std::shared_ptr<HandlerArena> _handlerArena;
+
 	/// @brief The handler for data type specific functionality, or nullptr, if the data type hans not been loaded yet
-	std::unique_ptr<AbstractTemplateInputHandler> _handler;
+	HandlerArena::Pointer<AbstractTemplateInputHandler> _handler;
+
+	/// @brief The offset of the value within the payload of the read command, or std::nullopt if it is unknown.
+	std::optional<std::size_t> _offset;
+
+	/// @brief The scaling to apply to the raw value, or std::nullopt if the value is not scaled
+	std::optional<Scaling> _scaling;
+
+	/// @brief The number of the bit within the byte at _offset, if the value is a bit packed together with other bits,
+	/// or std::nullopt if the value is not a packed bit. Bit numbers larger than 7 refer to the following bytes.
+	std::optional<std::size_t> _bitOffset;
 
 	/// @class xentara::plugins::templateDriver::TemplateInput
-	/// @todo add information needed to decode the value from the payload of a read command, like e.g. a data offset.
+	/// @todo add any other information needed to decode the value from the payload of a read command.
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "TemplateInputHandler.hpp"
 
 #include "Attributes.hpp"
+#include "ByteOrder.hpp"
+#include "CustomError.hpp"
 #include "TemplateIoTransaction.hpp"
 
 #include <xentara/data/DataType.hpp>
@@ -10,6 +12,9 @@
 #include <xentara/model/Attribute.hpp>
 #include <xentara/utils/tools/Concepts.hpp>
 
+#include <array>
+#include <functional>
+
 namespace xentara::plugins::templateDriver
 {
 	
@@ -18,6 +23,13 @@ using namespace std::literals;
 template <typename ValueType>
 const model::Attribute TemplateInputHandler<ValueType>::kValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadOnly, staticDataType() };
 
+template <typename ValueType>
+const AttributeTable<typename TemplateInputHandler<ValueType>::ReadHandleSource> TemplateInputHandler<ValueType>::kReadHandleSources {
+	{ std::array { std::cref(kValueAttribute) }, ReadHandleSource::Value },
+	{ PerValueReadState<ValueType>::attributes(), ReadHandleSource::ReadState },
+	{ CommonReadState::attributes(), ReadHandleSource::CommonReadState }
+};
+
 template <typename ValueType>
 constexpr auto TemplateInputHandler<ValueType>::staticDataType() -> const data::DataType &
 {
@@ -48,6 +60,54 @@ auto TemplateInputHandler<ValueType>::dataType() const -> const data::DataType &
 	return kValueAttribute.dataType();
 }
 
+template <typename ValueType>
+auto TemplateInputHandler<ValueType>::encodedSize() const noexcept -> std::optional<std::size_t>
+{
+	/// @todo return the number of bytes the value actually occupies in the payload of a read command
+	if constexpr (utils::tools::StringType<ValueType>)
+	{
+		// Strings have a variable size
+		return std::nullopt;
+	}
+	else
+	{
+		return sizeof(ValueType);
+	}
+}
+
+template <typename ValueType>
+auto TemplateInputHandler<ValueType>::bulkReadState() noexcept -> BulkReadState
+{
+	// Only integers and floating point values can be decoded in bulk
+	if constexpr (utils::tools::Integral<ValueType> || std::floating_point<ValueType>)
+	{
+		return &_state;
+	}
+	else
+	{
+		return std::monostate {};
+	}
+}
+
+template <typename ValueType>
+auto TemplateInputHandler<ValueType>::booleanReadState() noexcept -> PerValueReadState<bool> *
+{
+	if constexpr (std::same_as<ValueType, bool>)
+	{
+		return &_state;
+	}
+	else
+	{
+		return nullptr;
+	}
+}
+
+template <typename ValueType>
+auto TemplateInputHandler<ValueType>::footprint() const noexcept -> Footprint
+{
+	return { ._handlerBytes = sizeof(*this) };
+}
+
 template <typename ValueType>
 auto TemplateInputHandler<ValueType>::forEachAttribute(const model::ForEachAttributeFunction &function, TemplateIoTransaction &ioTransaction) const -> bool
 {
@@ -74,24 +134,26 @@ auto TemplateInputHandler<ValueType>::forEachEvent(const model::ForEachEventFunc
 template <typename ValueType>
 auto TemplateInputHandler<ValueType>::makeReadHandle(const model::Attribute &attribute, TemplateIoTransaction &ioTransaction) const noexcept -> std::optional<data::ReadHandle>
 {
+	// Find out which part of the handler provides the attribute
+	const auto source = kReadHandleSources.find(attribute);
+	if (!source)
+	{
+		return std::nullopt;
+	}
+
 	// Get the data block
 	const auto &dataBlock = ioTransaction.readDataBlock();
-	
-	// Handle the value attribute separately
-	if (attribute == kValueAttribute)
+
+	// Ask the correct part for the handle
+	switch (source->_route)
 	{
+	case ReadHandleSource::Value:
 		return _state.valueReadHandle(dataBlock);
-	}
-	
-	// Handle the state attributes
-	if (auto handle = _state.makeReadHandle(dataBlock, attribute))
-	{
-		return handle;
-	}
-	// Also handle the common read state attributes from the I/O transaction
-	if (auto handle = ioTransaction.makeReadStateReadHandle(attribute))
-	{
-		return handle;
+	case ReadHandleSource::ReadState:
+		return _state.makeReadHandle(dataBlock, source->_index);
+	case ReadHandleSource::CommonReadState:
+		// The common read state attributes are inherited from the I/O transaction
+		return ioTransaction.makeReadStateReadHandle(source->_index);
 	}
 
 	return std::nullopt;
@@ -107,14 +169,38 @@ template <typename ValueType>
 auto TemplateInputHandler<ValueType>::updateReadState(WriteSentinel &writeSentinel,
 	std::chrono::system_clock::time_point timeStamp,
 	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+	std::optional<std::size_t> offset,
 	const CommonReadState::Changes &commonChanges,
 	PendingEventList &eventsToRaise) -> void
 {
 	// Check if we have a valid payload
 	if (payloadOrError)
 	{
-		/// @todo decode the value from the payload data
+		/// @todo decode values that are not simply stored at their offset in the byte order of the I/O component.
+		/// Large numbers of values can be converted using the functions in the kernels namespace.
 		ValueType value = {};
+		if (offset)
+		{
+			// Make sure the payload contains the value
+			const auto data = payloadOrError->get().data();
+			const auto size = encodedSize();
+			if (size && (*offset > data.size() || data.size() - *offset < *size))
+			{
+				_state.update(writeSentinel, timeStamp, utils::eh::unexpected(std::error_code(CustomError::PayloadTooShort)), commonChanges, eventsToRaise);
+				return;
+			}
+
+			// Decode numbers using the byte order of the I/O component, and treat any non-zero byte as true
+			if constexpr (byteOrder::Decodable<ValueType>)
+			{
+				value = byteOrder::decode<ValueType>(data.data() + *offset);
+			}
+			else if constexpr (std::same_as<ValueType, bool>)
+			{
+				value = data[*offset] != std::byte { 0 };
+			}
+			/// @todo decode strings
+		}
 		
 		/// @todo it may be advantageous to split the decoding of the value up according to value type, either by using helper functions,
 		/// or using if constexpr().
@@ -157,6 +243,12 @@ auto TemplateInputHandler<ValueType>::updateReadState(WriteSentinel &writeSentin
 	}
 }
 
+template <typename ValueType>
+auto TemplateInputHandler<ValueType>::keepReadState(WriteSentinel &writeSentinel) -> void
+{
+	_state.keep(writeSentinel);
+}
+
 /// @class xentara::plugins::templateDriver::TemplateInputHandler
 /// @todo change list of template instantiations to the supported types
 template class TemplateInputHandler<bool>;
@@ -2,10 +2,12 @@
 #pragma once
 
 #include "AbstractTemplateInputHandler.hpp"
+#include "AttributeTable.hpp"
 #include "PerValueReadState.hpp"
 
 #include <xentara/model/Attribute.hpp>
 
+#include <cstdint>
 #include <string>
 
 namespace xentara::plugins::templateDriver
@@ -27,6 +29,14 @@ public:
 
 	auto dataType() const -> const data::DataType & final;
 
+	auto encodedSize() const noexcept -> std::optional<std::size_t> final;
+
+	auto bulkReadState() noexcept -> BulkReadState final;
+
+	auto booleanReadState() noexcept -> PerValueReadState<bool> * final;
+
+	auto footprint() const noexcept -> Footprint final;
+
 	auto forEachAttribute(const model::ForEachAttributeFunction &function, TemplateIoTransaction &ioTransaction) const -> bool final;
 
 	auto forEachEvent(const model::ForEachEventFunction &function, TemplateIoTransaction &ioTransaction, std::shared_ptr<void> parent) -> bool final;
@@ -38,8 +48,11 @@ public:
 	auto updateReadState(WriteSentinel &writeSentinel,
 		std::chrono::system_clock::time_point timeStamp,
 		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		std::optional<std::size_t> offset,
 		const CommonReadState::Changes &commonChanges,
 		PendingEventList &eventsToRaise) -> void final;
+
+	auto keepReadState(WriteSentinel &writeSentinel) -> void final;
 		
 	/// @}
 
@@ -54,6 +67,20 @@ private:
 	/// This function returns the same value as dataType(), but is static and constexpr.
 	static constexpr auto staticDataType() -> const data::DataType &;
 
+	/// @brief The parts of the handler that provide the read handles for the attributes
+	enum class ReadHandleSource : std::uint8_t
+	{
+		/// @brief The value, provided by _state
+		Value,
+		/// @brief The per-value read state in _state
+		ReadState,
+		/// @brief The common read state of the I/O transaction
+		CommonReadState
+	};
+
+	/// @brief The readable attributes, and the parts of the handler that provide the read handles for them
+	static const AttributeTable<ReadHandleSource> kReadHandleSources;
+
 	/// @brief The state
 	/// @todo use the correct value type
 	PerValueReadState<ValueType> _state;
@@ -2,6 +2,7 @@
 #include "TemplateIoComponent.hpp"
 
 #include "Attributes.hpp"
+#include "Tasks.hpp"
 #include "TemplateIoTransaction.hpp"
 #include "TemplateInput.hpp"
 #include "TemplateOutput.hpp"
@@ -21,6 +22,8 @@
 #include <xentara/utils/json/decoder/Object.hpp>
 #include <xentara/utils/json/decoder/Errors.hpp>
 
+#include <limits>
+#include <string>
 #include <string_view>
 
 #ifdef _WIN32
@@ -34,13 +37,113 @@ namespace xentara::plugins::templateDriver
 
 using namespace std::literals;
 
+namespace
+{
+
+/// @brief Parses a probability between 0 and 1
+auto parseProbability(utils::json::decoder::Value &value) -> double
+{
+	const auto probability = value.asNumber<double>();
+
+	// Check that the value is valid
+	if (probability < 0.0 || probability > 1.0)
+	{
+		utils::json::decoder::throwWithLocation(value, std::runtime_error("probability in template I/O component must be between 0 and 1"));
+	}
+
+	return probability;
+}
+
+} // namespace
+
 auto TemplateIoComponent::load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void
 {
+	// The simulator is created once all its settings have been loaded
+	bool simulate = false;
+
 	// Go through all the members of the JSON object that represents this object
 	for (auto && [name, value] : jsonObject)
     {
+		if (name == "requestWindow"sv)
+		{
+			_requestWindow = value.asNumber<std::size_t>();
+		}
+		else if (name == "requestTimeout"sv)
+		{
+			_requestTimeout = std::chrono::milliseconds(value.asNumber<std::uint32_t>());
+
+			// Check that the value is valid
+			if (_requestTimeout <= 0ms)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("request timeout of template I/O component must be positive"));
+			}
+		}
+		else if (name == "startupConcurrency"sv)
+		{
+			_startupConcurrency = value.asNumber<std::size_t>();
+
+			// Check that the value is valid
+			if (_startupConcurrency == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("startup concurrency of template I/O component must be positive"));
+			}
+		}
+		else if (name == "cycleBudget"sv)
+		{
+			_cycleBudget._budget = std::chrono::microseconds(value.asNumber<std::uint32_t>());
+		}
+		else if (name == "simulate"sv)
+		{
+			simulate = value.asBool();
+		}
+		else if (name == "simulatedPattern"sv)
+		{
+			const auto pattern = Simulator::parsePattern(value.asString<std::string>());
+
+			// Check that the value is valid
+			if (!pattern)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown simulated pattern in template I/O component"));
+			}
+
+			_simulatorSettings._pattern = *pattern;
+		}
+		else if (name == "simulatedChangeProbability"sv)
+		{
+			_simulatorSettings._changeProbability = parseProbability(value);
+		}
+		else if (name == "simulatedLatency"sv)
+		{
+			_simulatorSettings._latency = std::chrono::milliseconds(value.asNumber<std::uint32_t>());
+		}
+		else if (name == "simulatedJitter"sv)
+		{
+			_simulatorSettings._jitter = std::chrono::milliseconds(value.asNumber<std::uint32_t>());
+		}
+		else if (name == "simulatedErrorProbability"sv)
+		{
+			_simulatorSettings._errorProbability = parseProbability(value);
+		}
+		else if (name == "simulatedConnectionErrorProbability"sv)
+		{
+			_simulatorSettings._connectionErrorProbability = parseProbability(value);
+		}
+		else if (name == "simulatedNotificationInterval"sv)
+		{
+			_simulatorSettings._notificationInterval = std::chrono::milliseconds(value.asNumber<std::uint32_t>());
+
+			// Check that the value is valid
+			if (_simulatorSettings._notificationInterval <= 0ms)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("simulated notification interval of template I/O component must be positive"));
+			}
+		}
+		else if (name == "reconnectTaskBudget"sv)
+		{
+			_reconnectStatistics.setBudget(std::chrono::microseconds(value.asNumber<std::uint32_t>()));
+		}
 		/// @todo load configuration parameters
-		if (name == "TODO"sv)
+		else if (name == "TODO"sv)
 		{
 			/// @todo parse the value correctly
 			auto todo = value.asNumber<std::uint64_t>();
@@ -60,6 +163,20 @@ auto TemplateIoComponent::load(utils::json::decoder::Object &jsonObject, config:
 		}
     }
 
+	// Create the simulated device, if requested
+	if (simulate)
+	{
+		_simulator = std::make_unique<Simulator>(_simulatorSettings,
+			[this](std::chrono::system_clock::time_point timeStamp, RequestId requestId, const auto &payloadOrError)
+			{
+				dispatchResponse(timeStamp, requestId, payloadOrError);
+			},
+			[this](std::chrono::system_clock::time_point timeStamp, std::uint16_t handlerIndex, std::size_t offset, std::span<const std::byte> data)
+			{
+				dispatchNotification(timeStamp, handlerIndex, offset, data);
+			});
+	}
+
 	/// @todo perform consistency and completeness checks
 	if (!"TODO")
 	{
@@ -69,14 +186,19 @@ auto TemplateIoComponent::load(utils::json::decoder::Object &jsonObject, config:
 }
 
 auto TemplateIoComponent::performReconnectTask(const process::ExecutionContext &context) -> void
+{
+	_reconnectStatistics.measure(context, [&] { performReconnect(context); });
+}
+
+auto TemplateIoComponent::performReconnect(const process::ExecutionContext &context) -> void
 {
 	// Only perform the reconnect if we are supposed to be connected in the first place
 	if (_connectionRequestCount.load(std::memory_order_relaxed) == 0)
 	{
 		return;
 	}
-	// Also don't reconnect if we are already connected
-	if (_handle)
+	// Also don't reconnect if we are already connected, or if the initial connection attempt is still running
+	if (connected() || connectPending())
 	{
 		return;
 	}
@@ -89,11 +211,67 @@ auto TemplateIoComponent::performReconnectTask(const process::ExecutionContext &
 	connect(context.scheduledTime());
 }
 
+auto TemplateIoComponent::performKeepAliveTask(const process::ExecutionContext &context) -> void
+{
+	// Only probe the connection if it is up. Broken connections are handled by the "reconnect" task.
+	if (!connected())
+	{
+		return;
+	}
+
+	// Send the probe
+	sendKeepAlive(context.scheduledTime());
+}
+
+auto TemplateIoComponent::sendKeepAlive(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	try
+	{
+		// Probe the simulated device, if the I/O component is simulated
+		if (_simulator)
+		{
+			_simulator->probe();
+			return;
+		}
+
+		/// @todo send a minimal request that the I/O component must answer, like e.g. reading a single status register,
+		// and wait for the response. The request should be as short as possible, so that it does not take up
+		// any significant bandwidth.
+
+		/// @todo if the probe function does not throw errors, but uses return types or internal handle state,
+		// throw an std::system_error here on failure, or call handleError() directly. If the probe is not answered in time,
+		// report CustomError::Timeout.
+	}
+	catch (const std::exception &)
+	{
+		// Get the error from the current exception using this special utility function
+		auto error = utils::eh::currentErrorCode();
+
+		// A timeout only affects the request itself for ordinary reads and writes, but a probe that is not answered means that
+		// the device no longer responds at all, which is the typical symptom of a dead connection.
+		if (error == CustomError::Timeout)
+		{
+			error = CustomError::KeepAliveTimeout;
+		}
+
+		// Report the error. handleError() will only act on errors that affect the connection as a whole.
+		handleError(timeStamp, error);
+	}
+}
+
 auto TemplateIoComponent::connect(std::chrono::system_clock::time_point timeStamp) -> void
 {
 	try
 	{
-		/// @todo try to establish the connection, and set the _handle object
+		// Connect to the simulated device, if the I/O component is simulated
+		if (_simulator)
+		{
+			_simulator->connect();
+		}
+		else
+		{
+			/// @todo try to establish the connection using a new Handle object, and store it in _handle
+		}
 
 		/// @todo if the connect function does not throw errors, but uses return types or internal handle state,
 		// throw an std::system_error here on failure, or call updateState() directly.
@@ -104,6 +282,11 @@ auto TemplateIoComponent::connect(std::chrono::system_clock::time_point timeStam
 
 		// The connection was successful
 		updateState(timeStamp, std::error_code());
+
+		// Publish the new connection state. This must be done after the handle was set, so that any thread
+		// that sees the connected state will also see the handle. It must also be done after the state was updated,
+		// so that an error reported by handleError() cannot be overwritten by the connected state.
+		_connectionState.store(ConnectionState::Connected, std::memory_order_release);
 	}
 	/// @todo if your connection function throws exceptions that are not derived from std::system_error, but that
 	// still provide some sort of error code, you should catch those exceptions separately and wrap the error code in a custom
@@ -120,19 +303,44 @@ auto TemplateIoComponent::connect(std::chrono::system_clock::time_point timeStam
 
 auto TemplateIoComponent::disconnect(std::chrono::system_clock::time_point timeStamp) -> void
 {
-	// Reset the handle in any case, even if we fail, because the connection state should be false after this
-	auto handle = std::exchange(_handle, Handle());
+	// Mark the connection as closed first, so that no other threads will attempt to use the handle. If the connection
+	// had already failed, handleError() has won the transition and closes the handle itself.
+	const auto oldState = _connectionState.exchange(ConnectionState::Disconnected, std::memory_order_acq_rel);
+	if (oldState == ConnectionState::Connected)
+	{
+		// Drop the handle in any case, even if we fail, because the connection state should be false after this. Other threads
+		// that are still using the handle keep it alive until they are done.
+		const auto handle = _handle.exchange(nullptr, std::memory_order_acq_rel);
 
-	/// @todo close the connection, ignoring any errors. If the disconnect function can throw exceptions,
-	// these shoudl be caucht and ignored.
+		/// @todo close the connection, ignoring any errors. If the disconnect function can throw exceptions,
+		// these shoudl be caucht and ignored.
+	}
+
+	// Withdraw the outstanding simulated requests and the subscriptions, so that nothing is delivered to the next connection
+	if (_simulator)
+	{
+		_simulator->cancel();
+	}
 
 	// This is always a graceful disconnect, regardless of what happened, so never include an error code.
 	updateState(timeStamp, CustomError::NotConnected);
 }
 
-auto TemplateIoComponent::updateState(std::chrono::system_clock::time_point timeStamp, std::error_code error, const ErrorSink *excludeErrorSink)
-	-> void
+auto TemplateIoComponent::updateState(std::chrono::system_clock::time_point timeStamp,
+	std::error_code error,
+	const ErrorSink *excludeErrorSink,
+	std::optional<ConnectionState> requiredState) -> void
 {
+	// handleError() may report an error from another thread while the state is being updated here
+	std::scoped_lock lock { _stateMutex };
+
+	// Drop the update if the connection has moved on since, e.g. if an error reported by handleError() has been overtaken
+	// by a graceful disconnect. The state is checked under the lock, so that the later transition is always published last.
+	if (requiredState && _connectionState.load(std::memory_order_acquire) != *requiredState)
+	{
+		return;
+	}
+
 	// First, check if anything changed
 	if (error == _lastError)
 	{
@@ -234,12 +442,15 @@ auto TemplateIoComponent::isConnectionError(std::error_code error) noexcept -> b
 		switch (CustomError(error.value()))
 		{
 		case CustomError::NotConnected:
+		case CustomError::KeepAliveTimeout:
 		case CustomError::UnknownError:
 			/// @todo add case statements for other relevant custom errors (like e.g. timeout) here
 			return true;
 
+		// Timeouts of individual pipelined requests are reported to the I/O transaction that sent the request only.
 		case CustomError::NoError:
 		case CustomError::NoData:
+		case CustomError::Timeout:
 		default:
 			return false;
 		}
@@ -252,6 +463,152 @@ auto TemplateIoComponent::isConnectionError(std::error_code error) noexcept -> b
 	}
 }
 
+auto TemplateIoComponent::addResponseHandler(std::reference_wrapper<ResponseHandler> handler) -> std::uint16_t
+{
+	// The index must fit into the upper 16 bits of a request ID
+	const auto index = _responseHandlers.size();
+	if (index > std::numeric_limits<std::uint16_t>::max())
+	{
+		/// @todo replace "I/O transactions" and "I/O component" with more descriptive names
+		throw std::runtime_error("too many I/O transactions for a single template I/O component");
+	}
+
+	_responseHandlers.push_back(handler);
+	return std::uint16_t(index);
+}
+
+auto TemplateIoComponent::acquireRequestSlot() noexcept -> bool
+{
+	// Without a window, only a simulated device is pipelined, and it accepts any number of requests
+	if (_requestWindow == 0)
+	{
+		_requestsInFlight.fetch_add(1, std::memory_order_acquire);
+		return true;
+	}
+
+	// Reserve a place, and give it back if the window was already full
+	if (_requestsInFlight.fetch_add(1, std::memory_order_acquire) >= _requestWindow)
+	{
+		releaseRequestSlot();
+		return false;
+	}
+
+	return true;
+}
+
+auto TemplateIoComponent::addReadPriority(std::uint32_t priority) noexcept -> std::size_t
+{
+	// Keep track of how many transactions have the highest priority
+	if (priority > _cycleBudget._highestPriority || _cycleBudget._readerCount == 0)
+	{
+		_cycleBudget._highestPriority = priority;
+		_cycleBudget._highestPriorityCount = 1;
+	}
+	else if (priority == _cycleBudget._highestPriority)
+	{
+		++_cycleBudget._highestPriorityCount;
+	}
+
+	// The transactions take turns in the order they were registered
+	return _cycleBudget._readerCount++;
+}
+
+auto TemplateIoComponent::admitRead(
+	std::chrono::system_clock::time_point cycleTime, std::size_t index, std::uint32_t priority) noexcept -> bool
+{
+	// Always admit the read if there is no budget
+	if (_cycleBudget._budget == std::chrono::microseconds::zero())
+	{
+		return true;
+	}
+
+	// Start a new cycle if necessary. Only the thread that succeeds in moving the cycle time forward resets the time spent.
+	const auto cycleTicks = cycleTime.time_since_epoch().count();
+	auto currentTicks = _cycleBudget._cycleTime.load(std::memory_order_relaxed);
+	if (cycleTicks > currentTicks &&
+		_cycleBudget._cycleTime.compare_exchange_strong(currentTicks, cycleTicks, std::memory_order_relaxed))
+	{
+		_cycleBudget._spent.store(0, std::memory_order_relaxed);
+
+		// Start the turn with the first transaction that was deferred in the last cycle, or with the first transaction
+		// if none were
+		const auto firstDeferred = _cycleBudget._firstDeferred.exchange(kNoReader, std::memory_order_relaxed);
+		_cycleBudget._turn.store(firstDeferred != kNoReader ? firstDeferred : 0, std::memory_order_relaxed);
+	}
+
+	// The read of a transaction whose priority is higher than that of all the others is never deferred
+	if (priority == _cycleBudget._highestPriority && _cycleBudget._highestPriorityCount == 1)
+	{
+		return true;
+	}
+
+	// Transactions before the start of the turn have to wait until the turn comes round to them again. Otherwise,
+	// they would use up the budget before the transactions that were deferred in the last cycle get to read.
+	if (index < _cycleBudget._turn.load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	// Admit the read if there is budget left
+	const std::chrono::steady_clock::duration spent { _cycleBudget._spent.load(std::memory_order_relaxed) };
+	if (spent < _cycleBudget._budget)
+	{
+		return true;
+	}
+
+	// Remember where the next turn must start
+	auto firstDeferred = _cycleBudget._firstDeferred.load(std::memory_order_relaxed);
+	while (index < firstDeferred &&
+		!_cycleBudget._firstDeferred.compare_exchange_weak(firstDeferred, index, std::memory_order_relaxed))
+	{
+	}
+
+	return false;
+}
+
+auto TemplateIoComponent::chargeRead(
+	std::chrono::system_clock::time_point cycleTime, std::chrono::steady_clock::duration duration) noexcept -> void
+{
+	// Only charge reads that belong to the current cycle
+	if (_cycleBudget._budget == std::chrono::microseconds::zero() ||
+		_cycleBudget._cycleTime.load(std::memory_order_relaxed) != cycleTime.time_since_epoch().count())
+	{
+		return;
+	}
+
+	_cycleBudget._spent.fetch_add(duration.count(), std::memory_order_relaxed);
+}
+
+auto TemplateIoComponent::dispatchResponse(std::chrono::system_clock::time_point timeStamp,
+	RequestId requestId,
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) -> void
+{
+	// Find the response handler. Responses with an unknown ID are simply ignored.
+	const auto handlerIndex = std::size_t(requestId >> 16);
+	if (handlerIndex >= _responseHandlers.size()) [[unlikely]]
+	{
+		return;
+	}
+
+	// Pass on the response
+	_responseHandlers[handlerIndex].get().handleResponse(timeStamp, std::uint16_t(requestId & 0xffff), payloadOrError);
+}
+
+auto TemplateIoComponent::dispatchNotification(std::chrono::system_clock::time_point timeStamp,
+	std::uint16_t handlerIndex,
+	std::size_t offset,
+	std::span<const std::byte> data) -> void
+{
+	// Find the response handler. Notifications for unknown handlers are simply ignored.
+	if (handlerIndex >= _responseHandlers.size()) [[unlikely]]
+	{
+		return;
+	}
+
+	// Pass on the notification
+	_responseHandlers[handlerIndex].get().handleNotification(timeStamp, offset, data);
+}
+
 auto TemplateIoComponent::requestConnect(std::chrono::system_clock::time_point timeStamp) noexcept -> void
 {
 	// increment the count
@@ -260,7 +617,23 @@ auto TemplateIoComponent::requestConnect(std::chrono::system_clock::time_point t
 	// connect if the old count was 0
 	if (oldCount == 0)
 	{
-		connect(timeStamp);
+		// Connect in the background, so that the other I/O components can connect at the same time
+		_connectPending.store(true, std::memory_order_relaxed);
+		try
+		{
+			_startupStrand.submit([this, timeStamp]() noexcept
+			{
+				connect(timeStamp);
+				_connectPending.store(false, std::memory_order_release);
+				_connectPending.notify_all();
+			});
+		}
+		// If the job could not be submitted, connect synchronously instead
+		catch (const std::exception &)
+		{
+			connect(timeStamp);
+			_connectPending.store(false, std::memory_order_release);
+		}
 	}
 }
 
@@ -272,29 +645,34 @@ auto TemplateIoComponent::requestDisconnect(std::chrono::system_clock::time_poin
 	// disconnect if the new count is 0
 	if (newCount == 0)
 	{
+		// Wait for a background connection attempt to finish first
+		_connectPending.wait(true, std::memory_order_acquire);
+
 		disconnect(timeStamp);
 	}
 }
 
 auto TemplateIoComponent::handleError(std::chrono::system_clock::time_point timeStamp, std::error_code error, const ErrorSink *sender) noexcept -> void
 {
-	// Ignore any new errors if we already have an error (the first error always wins).
-	if (_lastError)
+	// Check if this error affects the connection as a whole, and bail if it doesn't.
+	if (!isConnectionError(error))
 	{
 		return;
 	}
-	// Check if this error affects the connection as a whole, and bail if it doesn't. This function shoudl
-	if (!isConnectionError(error))
+	// Mark the connection as failed. This will fail if we are not connected, which means that we already have an error,
+	// or that another thread has beaten us to it. In either case, we ignore the new error, because the first error always wins.
+	auto expectedState = ConnectionState::Connected;
+	if (!_connectionState.compare_exchange_strong(expectedState, ConnectionState::Failed, std::memory_order_acq_rel, std::memory_order_relaxed))
 	{
 		return;
 	}
 
-	// Reset the handle
+	// Drop the handle. Other threads that are still using it keep it alive until they are done.
 	/// @todo gracefully close the handle, if this is necessary
-	_handle = Handle();
+	const auto handle = _handle.exchange(nullptr, std::memory_order_acq_rel);
 
-	// update the error state
-	updateState(timeStamp, error, sender);
+	// update the error state, unless the connection has been closed or reestablished in the meantime
+	updateState(timeStamp, error, sender, ConnectionState::Failed);
 }
 
 auto TemplateIoComponent::createChildElement(const skill::Element::Class &elementClass, skill::ElementFactory &factory)
@@ -314,6 +692,9 @@ auto TemplateIoComponent::createChildElement(const skill::Element::Class &elemen
 	}
 
 	/// @todo add any other supported child element types
+	/// @note Each entry in the model file creates exactly one element, with its own name and UUID, so a single entry cannot be
+	/// expanded into a range of inputs. Ranges of similar inputs must be declared as individual inputs that lie next to each
+	/// other in the payload. If "bulkDecode" is enabled on their I/O transaction, realize() detects such runs and decodes them in bulk.
 
 	return nullptr;
 }
@@ -324,7 +705,9 @@ auto TemplateIoComponent::forEachAttribute(const model::ForEachAttributeFunction
 	return
 		function(model::Attribute::kDeviceState) ||
 		function(attributes::kConnectionTime) ||
-		function(attributes::kDeviceError);
+		function(attributes::kDeviceError) ||
+		function(attributes::kMemoryFootprint) ||
+		_reconnectStatistics.forEachAttribute(function);
 }
 
 auto TemplateIoComponent::forEachEvent(const model::ForEachEventFunction &function) -> bool
@@ -341,7 +724,8 @@ auto TemplateIoComponent::forEachTask(const model::ForEachTaskFunction &function
 {
 	// Handle all the tasks we support
 	return
-		function(process::Task::kReconnect, sharedFromThis(&_reconnectTask));
+		function(process::Task::kReconnect, sharedFromThis(&_reconnectTask)) ||
+		function(tasks::kKeepAlive, sharedFromThis(&_keepAliveTask));
 
 	/// @todo handle any additional tasks this class supports
 }
@@ -361,6 +745,15 @@ auto TemplateIoComponent::makeReadHandle(const model::Attribute &attribute) cons
 	{
 		return _stateDataBlock.member(&State::_error);
 	}
+	else if (attribute == attributes::kMemoryFootprint)
+	{
+		return _footprintDataBlock.member(&FootprintState::_totalBytes);
+	}
+	// Try the timing statistics of the "reconnect" task
+	else if (auto handle = _reconnectStatistics.makeReadHandle(attribute))
+	{
+		return handle;
+	}
 
 	/// @todo handle any additional readable attributes this class supports
 
@@ -370,8 +763,28 @@ auto TemplateIoComponent::makeReadHandle(const model::Attribute &attribute) cons
 
 auto TemplateIoComponent::realize() -> void
 {
-	// Create the data block
+	// Create the data blocks
 	_stateDataBlock.create(memory::memoryResources::data());
+	_footprintDataBlock.create(memory::memoryResources::data());
+	_reconnectStatistics.realize();
+
+	// Pass the startup concurrency on to the startup pool, which is shared by the whole skill
+	if (_startupConcurrency > 0)
+	{
+		_startupStrand.pool().requestConcurrency(_startupConcurrency);
+	}
+
+	// Count our own state
+	_footprint._dataBytes += sizeof(State);
+}
+
+auto TemplateIoComponent::prepare() -> void
+{
+	// Publish the footprint. The I/O transactions have all added their footprints in their realize() functions by now.
+	// The footprint never changes after this, so we only need to write it once.
+	memory::WriteSentinel sentinel { _footprintDataBlock };
+	(*sentinel)._totalBytes = _footprint.total();
+	sentinel.commit(std::chrono::system_clock::now(), process::StaticEventList<1> {});
 }
 
 auto TemplateIoComponent::ReconnectTask::preparePreOperational(const process::ExecutionContext &context) -> Status
@@ -415,4 +828,42 @@ auto TemplateIoComponent::ReconnectTask::finishPostOperational(const process::Ex
 	_target.get().requestDisconnect(context.scheduledTime());
 }
 
+auto TemplateIoComponent::KeepAliveTask::preparePreOperational(const process::ExecutionContext &context) -> Status
+{
+	// The connection is requested by the "reconnect" task, so there is nothing to do here
+	return Status::Ready;
+}
+
+auto TemplateIoComponent::KeepAliveTask::preOperational(const process::ExecutionContext &context) -> Status
+{
+	// Do the same as in operational
+	operational(context);
+
+	return Status::Ready;
+}
+
+auto TemplateIoComponent::KeepAliveTask::operational(const process::ExecutionContext &context) -> void
+{
+	_target.get().performKeepAliveTask(context);
+}
+
+auto TemplateIoComponent::KeepAliveTask::preparePostOperational(const process::ExecutionContext &context) -> Status
+{
+	// Everything in the post operational stage is optional, so we can report ready right away
+	return Status::Ready;
+}
+
+auto TemplateIoComponent::KeepAliveTask::postOperational(const process::ExecutionContext &context) -> Status
+{
+	// We just do the same thing as in the operational stage
+	operational(context);
+
+	return Status::Ready;
+}
+
+auto TemplateIoComponent::KeepAliveTask::finishPostOperational(const process::ExecutionContext &context) -> void
+{
+	// The disconnect is requested by the "reconnect" task, so there is nothing to do here
+}
+
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
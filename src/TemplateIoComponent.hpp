@@ -3,6 +3,14 @@
 
 #include "Attributes.hpp"
 #include "CustomError.hpp"
+#include "Footprint.hpp"
+#include "HandlerArena.hpp"
+#include "ReadCommand.hpp"
+#include "Simulator.hpp"
+#include "StartupPool.hpp"
+#include "TaskStatistics.hpp"
+#include "Types.hpp"
+#include "WorkerPool.hpp"
 
 #include <xentara/memory/Array.hpp>
 #include <xentara/memory/ObjectBlock.hpp>
@@ -12,11 +20,22 @@
 #include <xentara/skill/Element.hpp>
 #include <xentara/skill/EnableSharedFromThis.hpp>
 #include <xentara/utils/core/Uuid.hpp>
+#include <xentara/utils/eh/expected.hpp>
 #include <xentara/utils/tools/Unique.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string_view>
 #include <functional>
 #include <forward_list>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
 
 namespace xentara::plugins::templateDriver
 {
@@ -36,6 +55,12 @@ public:
 		"deadbeef-dead-beef-dead-beefdeadbeef"_uuid,
 		"template driver I/O component">;
 
+	/// @brief This constructor gives the I/O component access to the worker pool and the startup pool of the skill
+	TemplateIoComponent(std::reference_wrapper<WorkerPool> workerPool, std::reference_wrapper<StartupPool> startupPool) :
+		_workerPool(workerPool), _startupStrand(startupPool)
+	{
+	}
+
 	/// @brief A handle used to access the I/O component
 	/// @todo implement a proper handle
 	class Handle final : private utils::tools::Unique
@@ -73,19 +98,156 @@ public:
 		virtual auto ioComponentStateChanged(std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void = 0;
 	};
 
+	/// @brief A tag used to match the response of a pipelined request to the request.
+	///
+	/// The upper 16 bits contain the index of the response handler that sent the request, as returned by addResponseHandler().
+	/// The lower 16 bits contain a sequence number chosen by the response handler.
+	using RequestId = std::uint32_t;
+
+	/// @brief Interface for objects that send pipelined requests, and want to be notified of the responses
+	class ResponseHandler
+	{
+	public:
+		/// @brief Virtual destructor
+		/// @note The destructor is pure virtual (= 0) to ensure that this class will remain abstract, even if we should remove all
+		/// other pure virtual functions later. This is not necessary, of course, but prevents the abstract class from becoming
+		/// instantiable by accident as a result of refactoring.
+		virtual ~ResponseHandler() = 0;
+
+		/// @brief Called when the response to a pipelined request was received.
+		/// @param timeStamp The time the response was received
+		/// @param sequence The sequence number that was passed to makeRequestId() when the request was sent
+		/// @param payloadOrError This is a variant-like type that will hold either the payload of the response, or an std::error_code object
+		/// containing the error reported by the I/O component.
+		/// @note This function is called from whichever thread receives the responses from the I/O component.
+		virtual auto handleResponse(std::chrono::system_clock::time_point timeStamp,
+			std::uint16_t sequence,
+			const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) -> void = 0;
+
+		/// @brief Called when the I/O component pushed a change notification for a subscription.
+		/// @param timeStamp The time the notification was received
+		/// @param offset The offset of the changed data within the payload of the response handler's read command
+		/// @param data The new data
+		/// @note This function is called from whichever thread receives the notifications from the I/O component.
+		virtual auto handleNotification(
+			std::chrono::system_clock::time_point timeStamp, std::size_t offset, std::span<const std::byte> data) -> void = 0;
+	};
+
 	/// @brief Adds an error sink
 	auto addErrorSink(std::reference_wrapper<ErrorSink> sink)
 	{
 		_errorSinks.push_front(sink);
 	}
 
+	/// @brief Adds a response handler
+	/// @return The index of the response handler, which must be passed to makeRequestId() when sending a request
+	auto addResponseHandler(std::reference_wrapper<ResponseHandler> handler) -> std::uint16_t;
+
+	/// @brief Creates the ID to tag a pipelined request with
+	/// @param handlerIndex The index of the response handler, as returned by addResponseHandler()
+	/// @param sequence A sequence number that allows the response handler to identify the request
+	static constexpr auto makeRequestId(std::uint16_t handlerIndex, std::uint16_t sequence) noexcept -> RequestId
+	{
+		return (RequestId(handlerIndex) << 16) | RequestId(sequence);
+	}
+
+	/// @brief Determines whether requests are pipelined
+	///
+	/// If requests are pipelined, I/O transactions send their requests without waiting for the response, and the response is
+	/// delivered to them later using ResponseHandler::handleResponse(). Otherwise, every read is a synchronous round trip.
+	///
+	/// Requests to a simulated device are always pipelined, because the simulated device answers asynchronously.
+	auto pipelined() const noexcept -> bool
+	{
+		return _requestWindow > 0 || _simulator;
+	}
+
+	/// @brief Returns the simulated device, or nullptr if the physical device is used
+	auto simulator() const noexcept -> Simulator *
+	{
+		return _simulator.get();
+	}
+
+	/// @brief Gets the time after which an outstanding pipelined request is considered lost
+	auto requestTimeout() const noexcept -> std::chrono::milliseconds
+	{
+		return _requestTimeout;
+	}
+
+	/// @brief Reserves a place in the window of outstanding pipelined requests.
+	///
+	/// Each successful call to this function must be balanced by a call to releaseRequestSlot() once the response was received,
+	/// or the request was abandoned.
+	/// @return true if a request may be sent, or false if the maximum number of requests is already outstanding. This is always
+	/// true if no window was configured, which can only happen if the device is simulated.
+	auto acquireRequestSlot() noexcept -> bool;
+
+	/// @brief Releases a place in the window of outstanding pipelined requests reserved by acquireRequestSlot().
+	auto releaseRequestSlot() noexcept -> void
+	{
+		_requestsInFlight.fetch_sub(1, std::memory_order_release);
+	}
+
+	/// @brief Checks whether an I/O transaction may read in the current cycle, or must defer its read to the next cycle.
+	///
+	/// If a cycle budget is configured, reads of I/O transactions are deferred once the reads of the current cycle have used
+	/// up the budget. Only a transaction whose priority is higher than that of all the other transactions is never deferred.
+	///
+	/// The transactions take turns: each cycle starts with the first transaction that was deferred in the last cycle, and the
+	/// transactions before it are deferred until the turn comes round to them again. The order of the turns is the order
+	/// the transactions were registered using addReadPriority().
+	///
+	/// The cycles are told apart by their scheduled time, so the budget only works as intended if the "read" tasks of all the
+	/// I/O transactions of this component are executed on the same track, in the order they were registered.
+	/// @param cycleTime The scheduled time of the current cycle
+	/// @param index The index of the I/O transaction returned by addReadPriority()
+	/// @param priority The priority of the I/O transaction
+	/// @return true if the transaction may read, or false if the read must be deferred
+	auto admitRead(std::chrono::system_clock::time_point cycleTime, std::size_t index, std::uint32_t priority) noexcept -> bool;
+
+	/// @brief Charges the time taken by a read to the budget of the current cycle
+	/// @param cycleTime The scheduled time of the cycle the read was performed in
+	/// @param duration The time taken by the read
+	auto chargeRead(std::chrono::system_clock::time_point cycleTime, std::chrono::steady_clock::duration duration) noexcept -> void;
+
+	/// @brief Registers the priority of an I/O transaction
+	///
+	/// This must be called from the realize() function of the I/O transaction.
+	/// @return The index of the I/O transaction, which must be passed to admitRead()
+	auto addReadPriority(std::uint32_t priority) noexcept -> std::size_t;
+
+	/// @brief Passes the response to a pipelined request on to the response handler that sent the request.
+	/// @param timeStamp The time the response was received
+	/// @param requestId The ID the request was tagged with
+	/// @param payloadOrError This is a variant-like type that will hold either the payload of the response, or an std::error_code object
+	/// containing the error reported by the I/O component.
+	/// @todo call this function from the code that receives the responses from the I/O component. Since pipelined requests do not
+	/// wait for their responses, the responses must be received asynchronously, e.g. on a thread that is started by connect().
+	auto dispatchResponse(std::chrono::system_clock::time_point timeStamp,
+		RequestId requestId,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) -> void;
+
+	/// @brief Passes a change notification on to the response handler that subscribed to the data.
+	/// @param timeStamp The time the notification was received
+	/// @param handlerIndex The index of the response handler, as returned by addResponseHandler(), that the subscription was
+	/// registered for.
+	/// @param offset The offset of the changed data within the payload of the response handler's read command
+	/// @param data The new data
+	/// @todo call this function from the code that receives unsolicited change notifications from the I/O component, e.g. from
+	/// the same thread that receives the responses to pipelined requests.
+	auto dispatchNotification(std::chrono::system_clock::time_point timeStamp,
+		std::uint16_t handlerIndex,
+		std::size_t offset,
+		std::span<const std::byte> data) -> void;
+
 	/// @brief Request that the I/O component be connected.
 	///
 	/// Each call to this function must be balanced by a call to requestDisconnect().
 	/// 
-	/// If this is the first request, then the connection will be attempted, and the function will not return until
-	/// the connection has been successfully established, or has failed. In either case, error sinks will be notified,
-	/// so any error sinks calling this must be prepared to have ioComponentStateChanged() called from within this function.
+	/// If this is the first request, then the connection will be attempted in the background using the startup pool of the skill,
+	/// so that the I/O components of the skill can connect concurrently. Use connectPending() to check whether the attempt
+	/// has finished. In either case, error sinks will be notified, so any error sinks calling this must be prepared to have
+	/// ioComponentStateChanged() called from another thread.
 	auto requestConnect(std::chrono::system_clock::time_point timeStamp) noexcept -> void;
 
 	/// @brief Request that the I/O component be disconnected.
@@ -104,15 +266,58 @@ public:
 	auto handleError(std::chrono::system_clock::time_point timeStamp, std::error_code error, const ErrorSink *sender = nullptr) noexcept -> void;
 
 	/// @brief Checks whether the I/O component is up
-	auto connected() const -> bool
+	///
+	/// This function is wait-free, and can be called from any thread.
+	auto connected() const noexcept -> bool
 	{
-		return bool(_handle);
+		return _connectionState.load(std::memory_order_acquire) == ConnectionState::Connected;
 	}
 
 	/// @brief Returns a handle to the I/O component
-	auto handle() const -> const Handle &
+	///
+	/// This function can be called from any thread. The handle stays valid for as long as the returned pointer is held, even
+	/// if the connection is closed by another thread in the meantime.
+	/// @return The handle, or nullptr if the I/O component is not connected
+	auto handle() const noexcept -> std::shared_ptr<Handle>
+	{
+		return _handle.load(std::memory_order_acquire);
+	}
+
+	/// @brief Returns the worker pool of the skill
+	auto workerPool() const noexcept -> WorkerPool &
+	{
+		return _workerPool;
+	}
+
+	/// @brief Returns the strand of the startup pool of the skill used for the connect and the initial reads
+	///
+	/// The connect and the initial reads of the I/O transactions all use the same connection to the physical device,
+	/// so they are run one after the other. Only the jobs of different I/O components run at the same time.
+	auto startupStrand() noexcept -> StartupPool::Strand &
+	{
+		return _startupStrand;
+	}
+
+	/// @brief Checks whether a connection attempt started by requestConnect() is still running in the background
+	///
+	/// This function is wait-free, and can be called from any thread.
+	auto connectPending() const noexcept -> bool
 	{
-		return _handle;
+		return _connectPending.load(std::memory_order_acquire);
+	}
+
+	/// @brief Adds the memory used by an I/O transaction to the memory footprint of the I/O component
+	///
+	/// This must be called from the realize() function of the I/O transaction.
+	auto addFootprint(const Footprint &footprint) noexcept -> void
+	{
+		_footprint += footprint;
+	}
+
+	/// @brief Returns the arena that the handlers of the skill data points are allocated from
+	auto handlerArena() const noexcept -> const std::shared_ptr<HandlerArena> &
+	{
+		return _handlerArena;
 	}
 
 	/// @name Virtual Overrides for skill::Element
@@ -136,6 +341,17 @@ public:
 	/// @}
 
 private:
+	/// @brief The state of the connection to the I/O component
+	enum class ConnectionState : std::uint8_t
+	{
+		/// @brief The connection has not been established yet, or was closed gracefully
+		Disconnected,
+		/// @brief The connection is up
+		Connected,
+		/// @brief The connection was lost due to an error
+		Failed
+	};
+
 	/// @brief This structure represents the current state of the I/O component
 	struct State
 	{
@@ -183,10 +399,59 @@ private:
 		std::reference_wrapper<TemplateIoComponent> _target;
 	};
 	
+	/// @brief This class providing callbacks for the Xentara scheduler for the "keepalive" task
+	class KeepAliveTask final : public process::Task
+	{
+	public:
+		/// @brief This constuctor attached the task to its target
+		KeepAliveTask(std::reference_wrapper<TemplateIoComponent> target) : _target(target)
+		{
+		}
+
+		/// @name Virtual Overrides for process::Task
+		/// @{
+
+		auto stages() const -> Stages final
+		{
+			return Stage::PreOperational | Stage::Operational | Stage::PostOperational;
+		}
+
+		auto preparePreOperational(const process::ExecutionContext &context) -> Status final;
+
+		auto preOperational(const process::ExecutionContext &context) -> Status final;
+
+		auto operational(const process::ExecutionContext &context) -> void final;
+
+		auto preparePostOperational(const process::ExecutionContext &context) -> Status final;
+
+		auto postOperational(const process::ExecutionContext &context) -> Status final;
+
+		auto finishPostOperational(const process::ExecutionContext &context) -> void final;
+
+		/// @}
+
+	private:
+		/// @brief A reference to the target element
+		std::reference_wrapper<TemplateIoComponent> _target;
+	};
+	
 	/// @brief This function is called by the "reconnect" task.
 	///
-	/// This function attempts to reconnect any disconnected I/O components.
+	/// This function calls performReconnect(), and records its timing statistics.
 	auto performReconnectTask(const process::ExecutionContext &context) -> void;
+	/// @brief Performs the work of the "reconnect" task.
+	///
+	/// This function attempts to reconnect any disconnected I/O components.
+	auto performReconnect(const process::ExecutionContext &context) -> void;
+
+	/// @brief This function is called by the "keepalive" task.
+	///
+	/// This function sends a probe request to the I/O component if it is connected, so that a broken connection
+	/// is detected even if no read or write is currently due.
+	auto performKeepAliveTask(const process::ExecutionContext &context) -> void;
+
+	/// @brief Sends a probe request to the I/O component and reports any errors to handleError().
+	auto sendKeepAlive(std::chrono::system_clock::time_point timeStamp) -> void;
 
 	/// @brief Attempts to establish a connection to the I/O component and updates the state accordingly.
 	///
@@ -199,7 +464,17 @@ private:
 	auto disconnect(std::chrono::system_clock::time_point timeStamp) -> void;
 
 	/// @brief Updates the state and sends events
-	auto updateState(std::chrono::system_clock::time_point timeStamp, std::error_code error, const ErrorSink *excludeErrorSink = nullptr) -> void;
+	///
+	/// This function may be called from different threads at the same time, e.g. by disconnect() and by handleError().
+	/// @param timeStamp The time stamp of the update
+	/// @param error The new error code
+	/// @param excludeErrorSink An error sink that should not be notified, or nullptr to notify all error sinks
+	/// @param requiredState If set, the state is only updated if the connection is still in this state. This is used to drop
+	/// errors that have been overtaken by a later transition, e.g. by a graceful disconnect.
+	auto updateState(std::chrono::system_clock::time_point timeStamp,
+		std::error_code error,
+		const ErrorSink *excludeErrorSink = nullptr,
+		std::optional<ConnectionState> requiredState = std::nullopt) -> void;
 
 	/// @brief Checks whether an error is the result of a lost connection
 	static auto isConnectionError(std::error_code error) noexcept -> bool;
@@ -211,8 +486,20 @@ private:
 
 	auto realize() -> void final;
 
+	auto prepare() -> void final;
+
 	/// @}
 
+	/// @brief The worker pool of the skill
+	std::reference_wrapper<WorkerPool> _workerPool;
+	/// @brief The strand of the startup pool of the skill used for the connect and the initial reads
+	StartupPool::Strand _startupStrand;
+	/// @brief Set while a connection attempt started by requestConnect() is running in the background
+	std::atomic<bool> _connectPending { false };
+
+	/// @brief The arena that the handlers of the skill data points are allocated from
+	std::shared_ptr<HandlerArena> _handlerArena { std::make_shared<HandlerArena>() };
+
 	/// @brief A Xentara event that is raised when the connection is established
 	process::Event _connectedEvent;
 	/// @brief A Xentara event that is raised when the connection is closed or lost
@@ -220,27 +507,111 @@ private:
 
 	/// @brief The "reconnect" task
 	ReconnectTask _reconnectTask { *this };
+	/// @brief The "keepalive" task
+	KeepAliveTask _keepAliveTask { *this };
+
+	/// @brief The timing statistics of the "reconnect" task
+	TaskStatistics _reconnectStatistics { { attributes::kReconnectLatency, attributes::kReconnectMaximumLatency,
+		attributes::kReconnectDuration, attributes::kReconnectMaximumDuration, attributes::kReconnectOverruns } };
 
 	/// @brief A list of objects that want to be notified of errors
 	std::forward_list<std::reference_wrapper<ErrorSink>> _errorSinks;
 
+	/// @brief The response handlers, indexed by the upper 16 bits of the request ID
+	std::vector<std::reference_wrapper<ResponseHandler>> _responseHandlers;
+
+	/// @brief The settings for the simulated device
+	Simulator::Settings _simulatorSettings;
+	/// @brief The simulated device, or nullptr if the physical device is used
+	std::unique_ptr<Simulator> _simulator;
+
+	/// @brief The maximum number of pipelined requests that may be outstanding at the same time, or 0 to disable pipelining.
+	/// A simulated device is pipelined in any case, and accepts any number of requests if this is 0.
+	///
+	/// Each I/O transaction only has a single request outstanding at a time, so the window only pipelines requests
+	/// of different I/O transactions.
+	std::size_t _requestWindow { 0 };
+	/// @brief The time after which an outstanding pipelined request is considered lost
+	std::chrono::milliseconds _requestTimeout { 1s };
+	/// @brief The number of connects and initial reads that may run at the same time during startup, or 0 to use the default
+	std::size_t _startupConcurrency { 0 };
+	/// @brief The number of pipelined requests that are currently outstanding
+	///
+	/// This is modified by the read tasks of all transactions on every read, so it is kept in its own cache line.
+	alignas(kCacheLineSize) std::atomic<std::size_t> _requestsInFlight { 0 };
+
+	/// @brief A transaction index that denotes no transaction
+	static constexpr std::size_t kNoReader = std::numeric_limits<std::size_t>::max();
+
+	/// @brief The state used to limit the time spent reading in each cycle
+	struct
+	{
+		/// @brief The time the reads of a single cycle may take before lower priority reads are deferred, or 0 for no limit
+		std::chrono::microseconds _budget { 0 };
+		/// @brief The highest priority of any of the I/O transactions
+		std::uint32_t _highestPriority { 0 };
+		/// @brief The number of I/O transactions that have the highest priority. Reads with the highest priority are only
+		/// exempt from the budget if there is exactly one such transaction.
+		std::size_t _highestPriorityCount { 0 };
+		/// @brief The number of I/O transactions registered using addReadPriority()
+		std::size_t _readerCount { 0 };
+		/// @brief The scheduled time of the current cycle, as a count of the ticks of std::chrono::system_clock
+		std::atomic<std::chrono::system_clock::rep> _cycleTime { 0 };
+		/// @brief The time spent reading in the current cycle, as a count of the ticks of std::chrono::steady_clock
+		std::atomic<std::chrono::steady_clock::rep> _spent { 0 };
+		/// @brief The index of the first I/O transaction whose turn it is in the current cycle
+		std::atomic<std::size_t> _turn { 0 };
+		/// @brief The smallest index of an I/O transaction whose read was deferred in the current cycle, or kNoReader if none were
+		std::atomic<std::size_t> _firstDeferred { kNoReader };
+	} _cycleBudget;
+
 	/// @brief The number of people who would like this component to be connected
 	std::atomic<std::size_t> _connectionRequestCount { 0 };
 
-	/// @brief A handle to the I/O component
-	Handle _handle;
+	/// @brief The connection state.
+	///
+	/// This is the only part of the connection state that is read by other threads. All transitions are made atomically,
+	/// so that only one thread can ever win a transition. In particular, only a single thread can move the state from
+	/// ConnectionState::Connected to ConnectionState::Failed, which makes sure that the first error always wins. The thread
+	/// that wins the transition is the only one that may replace _handle.
+	///
+	/// This is read by all transactions before every read and write, so it is kept apart from _requestsInFlight to avoid
+	/// false sharing with it.
+	alignas(kCacheLineSize) std::atomic<ConnectionState> _connectionState { ConnectionState::Disconnected };
+
+	// Check that the connection state is lock free, so that connected() is wait-free
+	static_assert(decltype(_connectionState)::is_always_lock_free);
+
+	/// @brief A handle to the I/O component, or nullptr if the I/O component is not connected
+	///
+	/// The handle is shared, so that disconnect() and handleError() can drop it while other threads are still using it for a
+	/// read or write. Those threads keep the handle alive until they are done with it.
+	/// @todo Make sure that closing the handle while another thread is still using it is safe, e.g. by only shutting down
+	/// the socket, and releasing the resources in the destructor of Handle.
+	std::atomic<std::shared_ptr<Handle>> _handle;
 	/// @brief The last error we encountered.
 	/// 
 	/// May have the following values:
 	/// - If the connection is open, this will be a default constructed std::error_code object
 	/// - If the connection was closed gracefully, this will be CustomError::NotConnected;
 	/// - Otherwise, this will contain an appropriate error code
+	/// 
+	/// @note This is protected by _stateMutex.
 	std::error_code _lastError { CustomError::NotConnected };
+	/// @brief Serializes calls to updateState()
+	std::mutex _stateMutex;
 
 	/// @brief The data block that contains the state
 	memory::ObjectBlock<State> _stateDataBlock;
+
+	/// @brief The memory used by this I/O component, including all its I/O transactions
+	Footprint _footprint;
+	/// @brief The data block that publishes the memory footprint
+	memory::ObjectBlock<FootprintState> _footprintDataBlock;
 };
 
 inline TemplateIoComponent::ErrorSink::~ErrorSink() = default;
 
+inline TemplateIoComponent::ResponseHandler::~ResponseHandler() = default;
+
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
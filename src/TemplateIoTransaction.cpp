@@ -22,6 +22,10 @@
 #include <xentara/utils/json/decoder/Errors.hpp>
 #include <xentara/utils/eh/currentErrorCode.hpp>
 
+#include <algorithm>
+#include <span>
+#include <utility>
+
 namespace xentara::plugins::templateDriver
 {
 
@@ -53,8 +57,60 @@ auto TemplateIoTransaction::load(utils::json::decoder::Object &jsonObject, confi
 	// Go through all the members of the JSON object that represents this object
 	for (auto && [name, value] : jsonObject)
     {
+		if (name == "parallelChunkSize"sv)
+		{
+			_parallelChunkSize = value.asNumber<std::size_t>();
+		}
+		else if (name == "skipUnchangedPayloads"sv)
+		{
+			_skipUnchangedPayloads = value.asBool();
+		}
+		else if (name == "minimumPollInterval"sv)
+		{
+			_adaptivePolling._minimumInterval = std::chrono::milliseconds(value.asNumber<std::uint32_t>());
+
+			// Check that the value is valid
+			if (_adaptivePolling._minimumInterval <= 0ms)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("minimum poll interval of template I/O transaction must be positive"));
+			}
+		}
+		else if (name == "maximumPollInterval"sv)
+		{
+			_adaptivePolling._maximumInterval = std::chrono::milliseconds(value.asNumber<std::uint32_t>());
+
+			// Check that the value is valid
+			if (_adaptivePolling._maximumInterval <= 0ms)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("maximum poll interval of template I/O transaction must be positive"));
+			}
+		}
+		else if (name == "subscribe"sv)
+		{
+			_subscription._enabled = value.asBool();
+		}
+		else if (name == "bulkDecode"sv)
+		{
+			_bulkDecode = value.asBool();
+		}
+		else if (name == "decodeChangedRegionsOnly"sv)
+		{
+			_decodeChangedRegionsOnly = value.asBool();
+		}
+		else if (name == "priority"sv)
+		{
+			_cycleBudget._priority = value.asNumber<std::uint32_t>();
+		}
+		else if (name == "readTaskBudget"sv)
+		{
+			_readStatistics.setBudget(std::chrono::microseconds(value.asNumber<std::uint32_t>()));
+		}
+		else if (name == "writeTaskBudget"sv)
+		{
+			_writeStatistics.setBudget(std::chrono::microseconds(value.asNumber<std::uint32_t>()));
+		}
 		/// @todo load configuration parameters
-		if (name == "TODO"sv)
+		else if (name == "TODO"sv)
 		{
 			/// @todo parse the value correctly
 			auto todo = value.asNumber<std::uint64_t>();
@@ -74,6 +130,30 @@ auto TemplateIoTransaction::load(utils::json::decoder::Object &jsonObject, confi
 		}
     }
 
+	// Notifications only change parts of the payload, so only the inputs in the changed regions should be updated
+	if (_subscription._enabled)
+	{
+		_decodeChangedRegionsOnly = true;
+	}
+
+	// Check the adaptive polling intervals
+	if (_adaptivePolling._minimumInterval > 0ms && _adaptivePolling._maximumInterval == 0ms)
+	{
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("minimum poll interval specified for template I/O transaction without maximum poll interval"));
+	}
+	if (_adaptivePolling._maximumInterval > 0ms)
+	{
+		if (_adaptivePolling._minimumInterval == 0ms)
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("maximum poll interval specified for template I/O transaction without minimum poll interval"));
+		}
+		if (_adaptivePolling._minimumInterval > _adaptivePolling._maximumInterval)
+		{
+			utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("minimum poll interval of template I/O transaction is larger than maximum poll interval"));
+		}
+		_adaptivePolling._interval = _adaptivePolling._minimumInterval;
+	}
+
 	/// @todo perform consistency and completeness checks
 	if (!"TODO")
 	{
@@ -114,7 +194,14 @@ auto TemplateIoTransaction::forEachAttribute(const model::ForEachAttributeFuncti
 		// Handle the read state attributes
 		_readState.forEachAttribute(function) ||
 		// Handle the write state attributes
-		_writeState.forEachAttribute(function);
+		_writeState.forEachAttribute(function) ||
+		// Handle the timing statistics of the tasks
+		_readStatistics.forEachAttribute(function) ||
+		_writeStatistics.forEachAttribute(function) ||
+		// Handle our own attributes
+		function(attributes::kMemoryFootprint) ||
+		function(attributes::kDeferredReads) ||
+		function(attributes::kDroppedReads);
 
 	/// @todo handle any additional attributes this class supports, including attributes inherited from the I/O component
 }
@@ -152,6 +239,28 @@ auto TemplateIoTransaction::makeReadHandle(const model::Attribute &attribute) co
 	{
 		return handle;
 	}
+	// Handle the timing statistics of the tasks
+	if (auto handle = _readStatistics.makeReadHandle(attribute))
+	{
+		return handle;
+	}
+	if (auto handle = _writeStatistics.makeReadHandle(attribute))
+	{
+		return handle;
+	}
+	// Handle our own attributes
+	if (attribute == attributes::kMemoryFootprint)
+	{
+		return _footprintDataBlock.member(&FootprintState::_totalBytes);
+	}
+	if (attribute == attributes::kDeferredReads)
+	{
+		return _cycleBudget._dataBlock.member(&CycleBudgetState::_deferredReads);
+	}
+	if (attribute == attributes::kDroppedReads)
+	{
+		return _pendingRead._dataBlock.member(&PendingReadState::_droppedReads);
+	}
 
 	/// @todo handle any additional readable attributes this class supports, including attributes inherited from the I/O component
 
@@ -168,10 +277,10 @@ auto TemplateIoTransaction::forEachReadStateEvent(const model::ForEachEventFunct
 	return _readState.forEachEvent(function, sharedFromThis());
 }
 
-auto TemplateIoTransaction::makeReadStateReadHandle(const model::Attribute &attribute) const noexcept
+auto TemplateIoTransaction::makeReadStateReadHandle(std::size_t index) const noexcept
 	-> std::optional<data::ReadHandle>
 {
-	return _readState.makeReadHandle(_readDataBlock, attribute);
+	return _readState.makeReadHandle(_readDataBlock, index);
 }
 
 auto TemplateIoTransaction::realize() -> void
@@ -179,15 +288,79 @@ auto TemplateIoTransaction::realize() -> void
 	// Track the buffer size we need for pending events
 	std::size_t readEventCount { 0 };
 	std::size_t writeEventCount { 0 };
+	// Track the size of the separate event buffers used when updating the inputs in parallel
+	std::size_t chunkEventCount { 0 };
+
+	// Count the memory used by the data arrays
+	DataArrayFootprint dataArrayFootprint;
+
+	// The inputs are only updated outside the read task if responses or notifications arrive on other threads
+	_lockInputs = _ioComponent.get().pipelined() || _subscription._enabled;
 
 	// Add our own states
 	_readState.attach(_readDataArray, readEventCount);
 	_writeState.attach(_writeDataArray, writeEventCount);
 
-	// Attach all the inputs
-	for (auto &&input : _inputs)
+	// Find the inputs that can be decoded in bulk
+	findBulkInputRuns();
+
+	// Make the simulated payload large enough to contain the data of all the inputs
+	if (_ioComponent.get().simulator())
+	{
+		// The simulator generates whole 16-bit words
+		_simulatedPayload.resize((expectedPayloadSize() + 1) & ~std::size_t(1));
+	}
+
+	// Attach the inputs that are decoded in bulk. The values of each run must be attached first, so that they lie next to each other.
+	for (auto &&run : _bulkInputRuns)
+	{
+		run->attachValues(_readDataArray);
+		for (auto inputIndex = run->firstInput(); inputIndex < run->firstInput() + run->inputCount(); ++inputIndex)
+		{
+			_inputs[inputIndex].get().attachInput(_readDataArray, readEventCount);
+		}
+	}
+
+	// Attach the scaled inputs and the packed bits
+	_scaledInputs.attachInputs(_readDataArray, readEventCount);
+	_packedBits.attachInputs(_readDataArray, readEventCount);
+
+	// Attach all the other inputs
+	if (_parallelChunkSize == 0 || _individualInputs.size() <= _parallelChunkSize)
+	{
+		for (auto &&input : _individualInputs)
+		{
+			input.get().attachInput(_readDataArray, readEventCount);
+		}
+	}
+	// If the inputs are updated in parallel, each chunk needs its own event buffer
+	else
 	{
-		input.get().attachInput(_readDataArray, readEventCount);
+		const auto chunkCount = (_individualInputs.size() + _parallelChunkSize - 1) / _parallelChunkSize;
+		_readBuffers._chunkEvents = std::vector<PendingEventList>(chunkCount);
+		for (std::size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+		{
+			// Keep the data of each chunk in its own cache lines, since the chunks are written by different threads
+			if (chunkIndex > 0)
+			{
+				separateCacheLines(_readDataArray);
+			}
+
+			// Attach the inputs of this chunk, and count their events separately
+			std::size_t eventCount { 0 };
+			const auto chunkEnd = std::min(_individualInputs.size(), (chunkIndex + 1) * _parallelChunkSize);
+			for (auto inputIndex = chunkIndex * _parallelChunkSize; inputIndex < chunkEnd; ++inputIndex)
+			{
+				_individualInputs[inputIndex].get().attachInput(_readDataArray, eventCount);
+			}
+
+			_readBuffers._chunkEvents[chunkIndex].reset(eventCount);
+			readEventCount += eventCount;
+			chunkEventCount += eventCount;
+		}
+
+		// Make sure the worker threads are running
+		_ioComponent.get().workerPool().start();
 	}
 	// Attach all the outputs
 	for (auto &&output : _outputs)
@@ -195,13 +368,62 @@ auto TemplateIoTransaction::realize() -> void
 		output.get().attachOutput(_writeDataArray, writeEventCount);
 	}
 
+	// Pad the end of the arrays, so that the last objects do not share a cache line with whatever data the memory
+	// resource places after the data blocks. Together with the alignment of the padding, which also aligns the start of the
+	// data blocks, this makes sure that the data blocks of different transactions never share a cache line.
+	separateCacheLines(_readDataArray);
+	separateCacheLines(_writeDataArray);
+
 	// Create the data blocks
 	_readDataBlock.create(memory::memoryResources::data());
 	_writeDataBlock.create(memory::memoryResources::data());
 
 	// Reserve space in the buffers
-	_runtimeBuffers._eventsToRaise.reset(std::max(readEventCount, writeEventCount));
-	_runtimeBuffers._outputsToNotify.reset(_outputs.size());
+	_readBuffers._eventsToRaise.reset(readEventCount);
+	_writeBuffers._eventsToRaise.reset(writeEventCount);
+	_writeBuffers._outputsToNotify.reset(_outputs.size());
+
+	// Record the memory used by the data arrays and the buffers
+	_footprint._dataBytes = dataArrayFootprint.bytes();
+	_footprint._eventBufferBytes = (readEventCount + writeEventCount + chunkEventCount) * sizeof(std::reference_wrapper<process::Event>);
+	_footprint._outputListBytes = _outputs.size() * sizeof(std::reference_wrapper<AbstractOutput>);
+	// Record the memory used by the handlers of the skill data points
+	for (auto &&input : _inputs)
+	{
+		_footprint += input.get().handlerFootprint();
+	}
+
+	// Publish the footprint. This never changes, so we only need to write it once.
+	_footprintDataBlock.create(memory::memoryResources::data());
+	{
+		memory::WriteSentinel sentinel { _footprintDataBlock };
+		(*sentinel)._totalBytes = _footprint.total();
+		sentinel.commit(std::chrono::system_clock::now(), process::StaticEventList<1> {});
+	}
+
+	// Include the footprint in the totals of the I/O component
+	_ioComponent.get().addFootprint(_footprint);
+
+	// Create the data blocks for the timing statistics
+	_readStatistics.realize();
+	_writeStatistics.realize();
+
+	// Register our priority with the I/O component, and publish the initial deferral count
+	_cycleBudget._index = _ioComponent.get().addReadPriority(_cycleBudget._priority);
+	_cycleBudget._dataBlock.create(memory::memoryResources::data());
+	{
+		memory::WriteSentinel sentinel { _cycleBudget._dataBlock };
+		(*sentinel)._deferredReads = 0;
+		sentinel.commit(std::chrono::system_clock::now(), process::StaticEventList<1> {});
+	}
+
+	// Publish the initial drop count
+	_pendingRead._dataBlock.create(memory::memoryResources::data());
+	{
+		memory::WriteSentinel sentinel { _pendingRead._dataBlock };
+		(*sentinel)._droppedReads = 0;
+		sentinel.commit(std::chrono::system_clock::now(), process::StaticEventList<1> {});
+	}
 }
 
 auto TemplateIoTransaction::prepare() -> void
@@ -211,6 +433,36 @@ auto TemplateIoTransaction::prepare() -> void
 	_readCommand.reset(new ReadCommand);
 
 	/// @todo provide the information needed to decode the value to the inputs, like e.g. the correct data data offsets.
+
+	// Reserve space for the expected payload size in the payload cache, if it is used, so that no memory needs to be allocated
+	// when the first payload is received. Payloads that are larger than expected will still allocate once.
+	if (_skipUnchangedPayloads || _decodeChangedRegionsOnly || _adaptivePolling._maximumInterval > 0ms || _subscription._enabled)
+	{
+		/// @todo if the size of the payload is also known from the read command, use that instead
+		const auto payloadSize = expectedPayloadSize();
+		_payloadCache.reserve(payloadSize);
+		if (_subscription._enabled)
+		{
+			_subscription._image.resize(payloadSize);
+		}
+	}
+
+	// Build the index of payload regions
+	if (_decodeChangedRegionsOnly)
+	{
+		std::vector<std::optional<PayloadRegion>> regions;
+		regions.reserve(_inputs.size());
+		_indexedInputs.resize(_inputs.size());
+		for (std::size_t inputIndex = 0; inputIndex < _inputs.size(); ++inputIndex)
+		{
+			const auto &region = regions.emplace_back(_inputs[inputIndex].get().payloadRegion());
+			// The index skips empty regions, so inputs with an empty region must be treated like inputs without a known location
+			_indexedInputs[inputIndex] = region && region->_size > 0;
+		}
+
+		_regionIndex.build(regions, PayloadCache::kBlockSize);
+		_dirtyInputs.assign(_inputs.size(), false);
+	}
 }
 
 auto TemplateIoTransaction::ioComponentStateChanged(std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void
@@ -218,13 +470,165 @@ auto TemplateIoTransaction::ioComponentStateChanged(std::chrono::system_clock::t
 	// We cannot reset the error to Ok because we don't have a read command payload. So we use the special custom error code instead.
 	auto effectiveError = error ? error : CustomError::NoData;
 
+	// Any outstanding pipelined request will never be answered now, so give back its place in the request window
+	if (abandonReadRequest())
+	{
+		_ioComponent.get().releaseRequestSlot();
+	}
+
 	// Update the inputs. We do not notify the I/O component, because that is who this message comes from in the first place.
 	// Note: the write state is not updated, because the write state simply contains the last write error, which is unaffected
 	// by I/O component errors.
 	updateInputs(timeStamp, utils::eh::unexpected(effectiveError));
+
+	// Register for change notifications once the connection is up
+	if (_subscription._enabled && !error)
+	{
+		subscribe(timeStamp);
+	}
+}
+
+auto TemplateIoTransaction::subscribe(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	try
+	{
+		// Subscribe to the simulated device, if the I/O component is simulated. The simulator pushes the changes to
+		// TemplateIoComponent::dispatchNotification() on its own thread.
+		if (auto simulator = _ioComponent.get().simulator())
+		{
+			simulator->subscribe(_responseHandlerIndex, _simulatedPayload);
+		}
+		else
+		{
+			/// @todo send a request to the I/O component that registers the payload regions of all the inputs for change notifications.
+			// The notifications must be passed to TemplateIoComponent::dispatchNotification() together with _responseHandlerIndex.
+
+			/// @todo if the subscribe function does not throw errors, but uses return types or internal handle state,
+			// throw an std::system_error here on failure, or call handleReadError() directly.
+		}
+	}
+	catch (const std::exception &)
+	{
+		// Get the error from the current exception using this special utility function
+		const auto error = utils::eh::currentErrorCode();
+		// Handle the error
+		handleReadError(timeStamp, error);
+	}
+}
+
+auto TemplateIoTransaction::performInitialRead(const process::ExecutionContext &context) -> bool
+{
+	// Take part in the startup the first time we are called, so that the startup pool is kept running until our initial read
+	// has finished. We only register here, so that transactions whose read task never runs don't keep the pool alive.
+	if (!std::exchange(_startupStarted, true))
+	{
+		_ioComponent.get().startupStrand().pool().addParticipant();
+	}
+
+	// Keep going until the initial read has finished
+	if (!advanceInitialRead(context))
+	{
+		return false;
+	}
+
+	// Let the startup pool know that we no longer need it
+	if (!std::exchange(_startupFinished, true))
+	{
+		_ioComponent.get().startupStrand().pool().participantFinished();
+	}
+
+	return true;
+}
+
+auto TemplateIoTransaction::advanceInitialRead(const process::ExecutionContext &context) -> bool
+{
+	switch (_initialReadState.load(std::memory_order_acquire))
+	{
+	case InitialReadState::NotStarted:
+		break;
+	case InitialReadState::Reading:
+		// A pipelined read is finished once the request is no longer outstanding. Reads in the background finish by themselves.
+		if (_ioComponent.get().pipelined())
+		{
+			return finishPipelinedInitialRead(context.scheduledTime());
+		}
+		return false;
+	case InitialReadState::Done:
+		return true;
+	}
+
+	// Wait for the I/O component to finish connecting
+	if (_ioComponent.get().connectPending())
+	{
+		return false;
+	}
+
+	// Don't bother reading if the I/O component could not be connected
+	if (!_ioComponent.get().connected())
+	{
+		_initialReadState.store(InitialReadState::Done, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Pipelined reads don't block, so just send the request. The response is checked for in subsequent calls.
+	const auto timeStamp = context.scheduledTime();
+	if (_ioComponent.get().pipelined())
+	{
+		// If the request window is full, try again in the next call
+		if (sendReadRequest(timeStamp))
+		{
+			_initialReadState.store(InitialReadState::Reading, std::memory_order_relaxed);
+		}
+		return false;
+	}
+
+	// Read in the background, so that the initial reads of the transactions of other I/O components can run at the same time.
+	// The initial reads of the transactions of the same I/O component run one after the other, because they share the connection.
+	_initialReadState.store(InitialReadState::Reading, std::memory_order_relaxed);
+	try
+	{
+		_ioComponent.get().startupStrand().submit([this, timeStamp]() noexcept
+		{
+			read(timeStamp);
+			_initialReadState.store(InitialReadState::Done, std::memory_order_release);
+		});
+	}
+	// If the job could not be submitted, read synchronously instead
+	catch (const std::exception &)
+	{
+		read(timeStamp);
+		_initialReadState.store(InitialReadState::Done, std::memory_order_relaxed);
+		return true;
+	}
+
+	return false;
+}
+
+auto TemplateIoTransaction::finishPipelinedInitialRead(std::chrono::system_clock::time_point timeStamp) -> bool
+{
+	// Check for a timeout if the request is still outstanding. This abandons the request if it has timed out.
+	if (_pendingRead._sequence.load(std::memory_order_acquire) != 0)
+	{
+		sendReadRequest(timeStamp);
+
+		// Keep waiting if the request is still outstanding
+		if (_pendingRead._sequence.load(std::memory_order_acquire) != 0)
+		{
+			return false;
+		}
+	}
+
+	// The response has arrived, the request has timed out, or the request was abandoned because the connection was lost
+	_initialReadState.store(InitialReadState::Done, std::memory_order_relaxed);
+	return true;
 }
 
 auto TemplateIoTransaction::performReadTask(const process::ExecutionContext &context) -> void
+{
+	_readStatistics.measure(context, [&] { performRead(context); });
+}
+
+auto TemplateIoTransaction::performRead(const process::ExecutionContext &context) -> void
 {
 	// Only perform the read only if the I/O component is connected
 	if (!_ioComponent.get().connected())
@@ -232,8 +636,85 @@ auto TemplateIoTransaction::performReadTask(const process::ExecutionContext &con
 		return;
 	}
 
-	// Read the data
-	read(context.scheduledTime());
+	// Skip this cycle if the transaction is quiet. This must be checked first, so that skipped cycles are not counted as deferrals.
+	const auto cycleTime = context.scheduledTime();
+	if (!readDue(cycleTime))
+	{
+		return;
+	}
+
+	// Defer the read to the next cycle if the cycle budget of the I/O component is used up
+	if (!admitRead(cycleTime))
+	{
+		return;
+	}
+
+	// Only move the adaptive polling schedule forward once the read actually takes place
+	scheduleNextRead(cycleTime);
+
+	// Read the data, either synchronously or pipelined
+	const auto startTick = std::chrono::steady_clock::now();
+	if (_ioComponent.get().pipelined())
+	{
+		sendReadRequest(cycleTime);
+	}
+	else
+	{
+		read(cycleTime);
+	}
+
+	// Charge the time taken to the cycle budget
+	_ioComponent.get().chargeRead(cycleTime, std::chrono::steady_clock::now() - startTick);
+}
+
+auto TemplateIoTransaction::admitRead(std::chrono::system_clock::time_point cycleTime) -> bool
+{
+	// Ask the I/O component
+	if (_ioComponent.get().admitRead(cycleTime, _cycleBudget._index, _cycleBudget._priority))
+	{
+		return true;
+	}
+
+	// Publish the new deferral count
+	memory::WriteSentinel sentinel { _cycleBudget._dataBlock };
+	(*sentinel)._deferredReads = ++_cycleBudget._deferredReads;
+	sentinel.commit(cycleTime, process::StaticEventList<1> {});
+
+	return false;
+}
+
+auto TemplateIoTransaction::readDue(std::chrono::system_clock::time_point timeStamp) -> bool
+{
+	// Always read if adaptive polling is disabled
+	if (_adaptivePolling._maximumInterval == 0ms)
+	{
+		return true;
+	}
+
+	// Tighten the interval as soon as a change was seen
+	if (_adaptivePolling._changeSeen.exchange(false, std::memory_order_relaxed))
+	{
+		_adaptivePolling._interval = _adaptivePolling._minimumInterval;
+		_adaptivePolling._nextRead =
+			std::min(_adaptivePolling._nextRead, _adaptivePolling._lastRead + _adaptivePolling._minimumInterval);
+	}
+
+	// Skip the cycle if the next read is not due yet
+	return timeStamp >= _adaptivePolling._nextRead;
+}
+
+auto TemplateIoTransaction::scheduleNextRead(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Nothing to do if adaptive polling is disabled
+	if (_adaptivePolling._maximumInterval == 0ms)
+	{
+		return;
+	}
+
+	// Schedule the next read, and back off further for the one after that
+	_adaptivePolling._lastRead = timeStamp;
+	_adaptivePolling._nextRead = timeStamp + _adaptivePolling._interval;
+	_adaptivePolling._interval = std::min(_adaptivePolling._interval * 2, _adaptivePolling._maximumInterval);
 }
 
 auto TemplateIoTransaction::read(std::chrono::system_clock::time_point timeStamp) -> void
@@ -258,6 +739,147 @@ auto TemplateIoTransaction::read(std::chrono::system_clock::time_point timeStamp
 	}
 }
 
+auto TemplateIoTransaction::sendReadRequest(std::chrono::system_clock::time_point timeStamp) -> bool
+{
+	// Check if the last request is still outstanding
+	if (auto outstanding = _pendingRead._sequence.load(std::memory_order_acquire); outstanding != 0)
+	{
+		// Keep waiting if the request has not timed out yet
+		if (timeStamp < _pendingRead._deadline)
+		{
+			return true;
+		}
+
+		// Abandon the request. If this fails, the response arrived in the meantime, and has already been handled.
+		if (_pendingRead._sequence.compare_exchange_strong(outstanding, 0, std::memory_order_acq_rel, std::memory_order_relaxed))
+		{
+			_ioComponent.get().releaseRequestSlot();
+			handleReadError(timeStamp, CustomError::Timeout);
+		}
+
+		// Send the next request in the next cycle
+		return true;
+	}
+
+	// Reserve a place in the request window. If the window is full, we drop the read and try again in the next cycle.
+	if (!_ioComponent.get().acquireRequestSlot())
+	{
+		// Publish the new drop count
+		memory::WriteSentinel sentinel { _pendingRead._dataBlock };
+		(*sentinel)._droppedReads = ++_pendingRead._droppedReads;
+		sentinel.commit(timeStamp, process::StaticEventList<1> {});
+
+		return false;
+	}
+
+	// Choose a new sequence number, skipping 0, which is reserved for "no request outstanding"
+	auto sequence = ++_pendingRead._lastSequence;
+	if (sequence == 0)
+	{
+		sequence = ++_pendingRead._lastSequence;
+	}
+
+	// Mark the request as outstanding before sending it, so that we are ready for the response
+	_pendingRead._deadline = timeStamp + _ioComponent.get().requestTimeout();
+	_pendingRead._sequence.store(sequence, std::memory_order_release);
+
+	try
+	{
+		// Send the request to the simulated device, if the I/O component is simulated. The simulator delivers the response
+		// to TemplateIoComponent::dispatchResponse() on its own thread.
+		if (auto simulator = _ioComponent.get().simulator())
+		{
+			simulator->send(TemplateIoComponent::makeRequestId(_responseHandlerIndex, sequence), _simulatedPayload);
+		}
+		else
+		{
+			/// @todo send the read command tagged with the request ID TemplateIoComponent::makeRequestId(_responseHandlerIndex, sequence),
+			// without waiting for the response. The code that receives the response must pass it to TemplateIoComponent::dispatchResponse()
+			// together with the request ID.
+
+			/// @todo if the send function does not throw errors, but uses return types or internal handle state,
+			// throw an std::system_error here on failure.
+		}
+	}
+	catch (const std::exception &)
+	{
+		// Get the error from the current exception using this special utility function
+		const auto error = utils::eh::currentErrorCode();
+
+		// Withdraw the request. If this fails, the request was already handled by someone else.
+		auto expectedSequence = sequence;
+		if (_pendingRead._sequence.compare_exchange_strong(expectedSequence, 0, std::memory_order_acq_rel, std::memory_order_relaxed))
+		{
+			_ioComponent.get().releaseRequestSlot();
+			handleReadError(timeStamp, error);
+		}
+	}
+
+	return true;
+}
+
+auto TemplateIoTransaction::abandonReadRequest() noexcept -> bool
+{
+	return _pendingRead._sequence.exchange(0, std::memory_order_acq_rel) != 0;
+}
+
+auto TemplateIoTransaction::handleResponse(std::chrono::system_clock::time_point timeStamp,
+	std::uint16_t sequence,
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) -> void
+{
+	// Mark the request as finished. If this fails, the response is for a request that has timed out or was abandoned,
+	// and must be ignored.
+	auto expectedSequence = sequence;
+	if (sequence == 0 ||
+		!_pendingRead._sequence.compare_exchange_strong(expectedSequence, 0, std::memory_order_acq_rel, std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	// Give back our place in the request window
+	_ioComponent.get().releaseRequestSlot();
+
+	// Process the response
+	if (payloadOrError)
+	{
+		updateInputs(timeStamp, payloadOrError);
+	}
+	else
+	{
+		handleReadError(timeStamp, payloadOrError.error());
+	}
+}
+
+auto TemplateIoTransaction::handleNotification(
+	std::chrono::system_clock::time_point timeStamp, std::size_t offset, std::span<const std::byte> data) -> void
+{
+	// Ignore notifications if we did not subscribe
+	if (!_subscription._enabled)
+	{
+		return;
+	}
+
+	std::scoped_lock lock { _inputsMutex };
+
+	// Refresh the image from the last payload if a read has happened since the last notification. The notification can only
+	// be applied once the image has been filled by a successful read.
+	if (_subscription._imageStale)
+	{
+		if (!_payloadCache.valid())
+		{
+			return;
+		}
+		const auto cached = _payloadCache.data();
+		_subscription._image.resize(cached.size());
+		_subscription._image.update(0, cached);
+		_subscription._imageStale = false;
+	}
+
+	// Apply the notification, and update the inputs. Only the inputs in the changed parts of the image will actually be decoded.
+	_subscription._image.update(offset, data);
+	updateInputsLocked(timeStamp, _subscription._image);
+}
+
 auto TemplateIoTransaction::handleReadError(std::chrono::system_clock::time_point timeStamp, std::error_code error)
 	-> void
 {
@@ -268,6 +890,11 @@ auto TemplateIoTransaction::handleReadError(std::chrono::system_clock::time_poin
 }
 
 auto TemplateIoTransaction::performWriteTask(const process::ExecutionContext &context) -> void
+{
+	_writeStatistics.measure(context, [&] { performWrite(context); });
+}
+
+auto TemplateIoTransaction::performWrite(const process::ExecutionContext &context) -> void
 {
 	// Only perform the read only if the I/O component is connected
 	if (!_ioComponent.get().connected())
@@ -282,7 +909,7 @@ auto TemplateIoTransaction::performWriteTask(const process::ExecutionContext &co
 auto TemplateIoTransaction::write(std::chrono::system_clock::time_point timeStamp) -> void
 {
 	// Protect use of the list of outputs to notify
-	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._outputsToNotify);
+	RuntimeBufferSentinel outputsToNotifySentinel(_writeBuffers._outputsToNotify);
 
 	// Create a command
 	WriteCommand command;
@@ -293,32 +920,40 @@ auto TemplateIoTransaction::write(std::chrono::system_clock::time_point timeStam
 		// Add the output
 		if (output.get().addToWriteCommand(command))
 		{
-			_runtimeBuffers._outputsToNotify.push_back(output);
+			_writeBuffers._outputsToNotify.push_back(output);
 		}
 	}
 
 	// If there were no pending outputs, just bail
-	if (_runtimeBuffers._outputsToNotify.empty())
+	if (_writeBuffers._outputsToNotify.empty())
 	{
 		return;
 	}
 
 	try
 	{
-		/// @todo send the command
+		// Write to the simulated device, if the I/O component is simulated
+		if (auto simulator = _ioComponent.get().simulator())
+		{
+			simulator->write(command);
+		}
+		else
+		{
+			/// @todo send the command
+		}
 
 		/// @todo if the write function does not throw errors, but uses return types or internal handle state,
 		// throw an std::system_error here on failure, or call handleWriteError() directly.
 
 		// The write was successful
-		updateOutputs(timeStamp, std::error_code(), _runtimeBuffers._outputsToNotify);
+		updateOutputs(timeStamp, std::error_code(), _writeBuffers._outputsToNotify);
 	}
 	catch (const std::exception &)
 	{
 		// Get the error from the current exception using this special utility function
 		const auto error = utils::eh::currentErrorCode();
 		// Handle the error
-		handleWriteError(timeStamp, error, _runtimeBuffers._outputsToNotify);
+		handleWriteError(timeStamp, error, _writeBuffers._outputsToNotify);
 	}
 }
 
@@ -333,45 +968,314 @@ auto TemplateIoTransaction::handleWriteError(std::chrono::system_clock::time_poi
 
 auto TemplateIoTransaction::updateInputs(std::chrono::system_clock::time_point timeStamp, const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError)
 	-> void
+{
+	// The inputs may be updated by several threads at the same time in pipelined and in subscription mode. Plain polling
+	// does not take the lock, so that it stays off the hot path of the read task.
+	std::unique_lock lock { _inputsMutex, std::defer_lock };
+	if (_lockInputs)
+	{
+		lock.lock();
+	}
+
+	// The payload replaces the image. The payload cache keeps a copy, so the image is only refreshed once a notification needs it.
+	_subscription._imageStale = true;
+
+	updateInputsLocked(timeStamp, payloadOrError);
+}
+
+auto TemplateIoTransaction::updateInputsLocked(std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) -> void
 {
 	// Protect use of the pending event buffer
-	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._eventsToRaise);
+	RuntimeBufferSentinel eventsToRaiseSentinel(_readBuffers._eventsToRaise);
 
 	// Make a write sentinel
 	memory::WriteSentinel sentinel { _readDataBlock };
 
 	// Update the common read state
-	const auto commonChanges = _readState.update(sentinel, timeStamp, payloadOrError.error(), _runtimeBuffers._eventsToRaise);
+	const auto commonChanges = _readState.update(sentinel, timeStamp, payloadOrError.error(), _readBuffers._eventsToRaise);
+
+	// Check which parts of the payload have changed
+	const auto payloadChanges = detectPayloadChanges(payloadOrError, commonChanges);
+
+	// Let adaptive polling know that something changed
+	if (_adaptivePolling._maximumInterval > 0ms && payloadChanges != PayloadChanges::None)
+	{
+		_adaptivePolling._changeSeen.store(true, std::memory_order_relaxed);
+	}
+
+	// If the payload is the same as last time, just carry the inputs over
+	if (payloadChanges == PayloadChanges::None)
+	{
+		for (auto &&input : _inputs)
+		{
+			input.get().keepReadState(sentinel);
+		}
+	}
+	// If only parts of the payload have changed, only update the affected inputs
+	else if (payloadChanges == PayloadChanges::Partial)
+	{
+		for (std::size_t inputIndex = 0; inputIndex < _inputs.size(); ++inputIndex)
+		{
+			auto &input = _inputs[inputIndex].get();
+			if (_dirtyInputs[inputIndex] || !_indexedInputs[inputIndex])
+			{
+				input.updateReadState(sentinel, timeStamp, payloadOrError, commonChanges, _readBuffers._eventsToRaise);
+				_dirtyInputs[inputIndex] = false;
+			}
+			else
+			{
+				input.keepReadState(sentinel);
+			}
+		}
 
+		// The packed bits were updated individually, so their copy of the last bits is out of date
+		_packedBits.invalidate();
+	}
 	// Update all the inputs
-	for (auto &&input : _inputs)
+	else
 	{
-		input.get().updateReadState(sentinel, timeStamp, payloadOrError, commonChanges, _runtimeBuffers._eventsToRaise);
+		// Update the inputs that are decoded in bulk
+		for (auto &&run : _bulkInputRuns)
+		{
+			run->updateReadStates(sentinel, timeStamp, payloadOrError, commonChanges, _readBuffers._eventsToRaise);
+		}
+
+		// Update the scaled inputs and the packed bits
+		_scaledInputs.updateReadStates(sentinel, timeStamp, payloadOrError, commonChanges, _readBuffers._eventsToRaise);
+		_packedBits.updateReadStates(sentinel, timeStamp, payloadOrError, commonChanges, _readBuffers._eventsToRaise);
+
+		// Update the other inputs
+		if (_readBuffers._chunkEvents.empty())
+		{
+			for (auto &&input : _individualInputs)
+			{
+				input.get().updateReadState(sentinel, timeStamp, payloadOrError, commonChanges, _readBuffers._eventsToRaise);
+			}
+		}
+		else
+		{
+			updateInputsInParallel(sentinel, timeStamp, payloadOrError, commonChanges);
+		}
 	}
 
 	// Commit the data and raise the events
-	sentinel.commit(timeStamp, _runtimeBuffers._eventsToRaise);
+	sentinel.commit(timeStamp, _readBuffers._eventsToRaise);
+}
+
+auto TemplateIoTransaction::detectPayloadChanges(
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+	const CommonReadState::Changes &commonChanges) -> PayloadChanges
+{
+	// Only check the payload if this was configured. Adaptive polling needs to know whether the payload changed, too.
+	if (!_skipUnchangedPayloads && !_decodeChangedRegionsOnly && _adaptivePolling._maximumInterval == 0ms)
+	{
+		// Subscription mode still needs the cache, because the image that notifications are applied to is refreshed from it
+		if (_subscription._enabled)
+		{
+			if (payloadOrError)
+			{
+				_payloadCache.update(payloadOrError->get().data());
+			}
+			else
+			{
+				_payloadCache.invalidate();
+			}
+		}
+
+		return PayloadChanges::All;
+	}
+
+	// On error, discard the cached payload, so that the next successful read will be decoded in any case
+	if (!payloadOrError)
+	{
+		_payloadCache.invalidate();
+		return PayloadChanges::All;
+	}
+
+	const auto data = payloadOrError->get().data();
+
+	// The inputs must all be updated if the quality or error changed, because the inputs need to update their change times
+	// and send change events. We must still cache the payload, so the cache is kept up to date.
+	if (commonChanges)
+	{
+		_payloadCache.update(data);
+		return PayloadChanges::All;
+	}
+
+	// If we don't have a region index, we can only check whether the payload has changed as a whole
+	if (!_decodeChangedRegionsOnly)
+	{
+		return _payloadCache.update(data) ? PayloadChanges::All : PayloadChanges::None;
+	}
+
+	// Mark the inputs in all the changed blocks
+	bool anyChanges { false };
+	const auto compared = _payloadCache.updateBlocks(data, [&](std::size_t blockIndex)
+		{
+			anyChanges = true;
+			_regionIndex.forEachInput(blockIndex, [&](std::size_t inputIndex) { _dirtyInputs[inputIndex] = true; });
+		});
+
+	// If the payload could not be compared, all the inputs must be updated
+	if (!compared)
+	{
+		return PayloadChanges::All;
+	}
+
+	return anyChanges ? PayloadChanges::Partial : PayloadChanges::None;
+}
+
+auto TemplateIoTransaction::expectedPayloadSize() const noexcept -> std::size_t
+{
+	std::size_t payloadSize { 0 };
+	for (auto &&input : _inputs)
+	{
+		if (const auto region = input.get().payloadRegion())
+		{
+			payloadSize = std::max(payloadSize, region->_offset + region->_size);
+		}
+	}
+
+	return payloadSize;
+}
+
+auto TemplateIoTransaction::findBulkInputRuns() -> void
+{
+	// Scaled inputs and packed bits are always decoded together, all other inputs that are not part of a run are decoded individually
+	auto addIndividualInput = [&](AbstractInput &input)
+	{
+		if (auto scaledState = input.scaledReadState())
+		{
+			_scaledInputs.add(input, *scaledState);
+		}
+		else if (auto packedBitState = input.packedBitReadState())
+		{
+			_packedBits.add(input, *packedBitState);
+		}
+		else
+		{
+			_individualInputs.push_back(input);
+		}
+	};
+
+	// If bulk decoding is disabled, all the inputs are decoded individually
+	if (!_bulkDecode)
+	{
+		for (auto &&input : _inputs)
+		{
+			addIndividualInput(input);
+		}
+		return;
+	}
+
+	// Collect the information we need about each input
+	std::vector<BulkReadState> states;
+	std::vector<std::optional<PayloadRegion>> regions;
+	states.reserve(_inputs.size());
+	regions.reserve(_inputs.size());
+	for (auto &&input : _inputs)
+	{
+		states.push_back(input.get().bulkReadState());
+		regions.push_back(input.get().payloadRegion());
+	}
+
+	// Checks whether an input can be decoded in bulk at all
+	auto canDecodeInBulk = [&](std::size_t inputIndex)
+	{
+		const auto valueSize = bulkValueSize(states[inputIndex]);
+		return valueSize != 0 && regions[inputIndex] && regions[inputIndex]->_size == valueSize;
+	};
+	// Checks whether an input continues the run of the input before it
+	auto continuesRun = [&](std::size_t inputIndex)
+	{
+		const auto &previousRegion = regions[inputIndex - 1];
+		return canDecodeInBulk(inputIndex) &&
+			states[inputIndex].index() == states[inputIndex - 1].index() &&
+			regions[inputIndex]->_offset == previousRegion->_offset + previousRegion->_size;
+	};
+
+	// Find the runs
+	for (std::size_t runStart = 0; runStart < _inputs.size();)
+	{
+		// Find the end of the run
+		auto runEnd = runStart + 1;
+		if (canDecodeInBulk(runStart))
+		{
+			while (runEnd < _inputs.size() && continuesRun(runEnd))
+			{
+				++runEnd;
+			}
+		}
+
+		// Only decode long enough runs in bulk
+		if (runEnd - runStart >= kMinimumBulkRunLength)
+		{
+			_bulkInputRuns.push_back(makeBulkInputRun(runStart,
+				std::span(states).subspan(runStart, runEnd - runStart), regions[runStart]->_offset));
+		}
+		else
+		{
+			for (auto inputIndex = runStart; inputIndex < runEnd; ++inputIndex)
+			{
+				addIndividualInput(_inputs[inputIndex]);
+			}
+		}
+
+		runStart = runEnd;
+	}
+}
+
+auto TemplateIoTransaction::updateInputsInParallel(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+	const CommonReadState::Changes &commonChanges) -> void
+{
+	// Update the chunks in parallel. Each input only writes to its own entries in the data block, so the chunks can safely
+	// share the write sentinel. The events are collected separately for each chunk.
+	_ioComponent.get().workerPool().forEachChunk(_readBuffers._chunkEvents.size(), [&](std::size_t chunkIndex)
+		{
+			auto &eventsToRaise = _readBuffers._chunkEvents[chunkIndex];
+			eventsToRaise.clear();
+
+			const auto chunkEnd = std::min(_individualInputs.size(), (chunkIndex + 1) * _parallelChunkSize);
+			for (auto inputIndex = chunkIndex * _parallelChunkSize; inputIndex < chunkEnd; ++inputIndex)
+			{
+				_individualInputs[inputIndex].get().updateReadState(writeSentinel, timeStamp, payloadOrError, commonChanges, eventsToRaise);
+			}
+		});
+
+	// Collect the events from all the chunks, so they can all be raised together when the data is committed
+	for (auto &&chunkEvents : _readBuffers._chunkEvents)
+	{
+		for (auto &&event : chunkEvents)
+		{
+			_readBuffers._eventsToRaise.push_back(event);
+		}
+		chunkEvents.clear();
+	}
 }
 
 auto TemplateIoTransaction::updateOutputs(std::chrono::system_clock::time_point timeStamp, std::error_code error, const OutputList &outputs) -> void
 {
 	// Protect use of the pending event buffer
-	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._eventsToRaise);
+	RuntimeBufferSentinel eventsToRaiseSentinel(_writeBuffers._eventsToRaise);
 
-	// Make a write sentinel
-	memory::WriteSentinel sentinel { _readDataBlock };
+	// Make a write sentinel. The write states live in the write data block, so that writing does not touch any data
+	// used by the read path.
+	memory::WriteSentinel sentinel { _writeDataBlock };
 
 	// Update the latest state
-	_writeState.update(sentinel, timeStamp, error, _runtimeBuffers._eventsToRaise);
+	_writeState.update(sentinel, timeStamp, error, _writeBuffers._eventsToRaise);
 
 	// Update all the relevant outputs
 	for (auto &&output : outputs)
 	{
-		output.get().updateWriteState(sentinel, timeStamp, error, _runtimeBuffers._eventsToRaise);
+		output.get().updateWriteState(sentinel, timeStamp, error, _writeBuffers._eventsToRaise);
 	}
 
 	// Commit the data and raise the events
-	sentinel.commit(timeStamp, _runtimeBuffers._eventsToRaise);
+	sentinel.commit(timeStamp, _writeBuffers._eventsToRaise);
 }
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
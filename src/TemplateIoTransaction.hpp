@@ -3,15 +3,23 @@
 
 #include "TemplateIoComponent.hpp"
 #include "Attributes.hpp"
+#include "BulkInputRun.hpp"
 #include "CommonReadState.hpp"
 #include "WriteState.hpp"
 #include "CustomError.hpp"
+#include "Footprint.hpp"
+#include "PackedBitGroup.hpp"
+#include "PayloadCache.hpp"
+#include "PayloadRegionIndex.hpp"
+#include "ScaledInputGroup.hpp"
+#include "TaskStatistics.hpp"
 #include "Types.hpp"
 #include "ReadCommand.hpp"
 #include "ReadTask.hpp"
 #include "WriteTask.hpp"
 
 #include <xentara/memory/Array.hpp>
+#include <xentara/memory/ObjectBlock.hpp>
 #include <xentara/model/ElementCategory.hpp>
 #include <xentara/process/Event.hpp>
 #include <xentara/skill/Element.hpp>
@@ -19,9 +27,14 @@
 #include <xentara/utils/core/Uuid.hpp>
 #include <xentara/utils/eh/expected.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string_view>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <vector>
 
 namespace xentara::plugins::templateDriver
@@ -34,7 +47,11 @@ class AbstractOutput;
 
 /// @brief A class representing a specific type of I/O transaction.
 /// @todo rename this class to something more descriptive
-class TemplateIoTransaction final : public skill::Element, public TemplateIoComponent::ErrorSink, public skill::EnableSharedFromThis<TemplateIoTransaction>
+class TemplateIoTransaction final :
+	public skill::Element,
+	public TemplateIoComponent::ErrorSink,
+	public TemplateIoComponent::ResponseHandler,
+	public skill::EnableSharedFromThis<TemplateIoTransaction>
 {
 public:
 	/// @brief The class object containing meta-information about this element type
@@ -47,7 +64,8 @@ public:
 
 	/// @brief This constructor attaches the transaction to its I/O component
 	TemplateIoTransaction(std::reference_wrapper<TemplateIoComponent> ioComponent) :
-		_ioComponent(ioComponent)
+		_ioComponent(ioComponent),
+		_responseHandlerIndex(ioComponent.get().addResponseHandler(*this))
 	{
 		ioComponent.get().addErrorSink(*this);
 	}
@@ -66,9 +84,9 @@ public:
 	auto forEachReadStateEvent(const model::ForEachEventFunction &function) -> bool;
 
 	/// @brief Creates a read-handle for an attribute that belong to the common read state.
-	/// @param attribute The attribute to create the handle for
-	/// @return A read handle for the attribute, or std::nullopt if the read state doesn't know the attribute
-	auto makeReadStateReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>;
+	/// @param index The position of the attribute in the list returned by CommonReadState::attributes()
+	/// @return A read handle for the attribute, or std::nullopt if the index is out of range
+	auto makeReadStateReadHandle(std::size_t index) const noexcept -> std::optional<data::ReadHandle>;
 
 	/// @brief Gets the data block that holds the data for the read operations
 	constexpr auto readDataBlock() noexcept -> DataBlock &
@@ -120,6 +138,18 @@ public:
 
 	/// @}
 
+	/// @name Virtual Overrides for TemplateIoComponent::ResponseHandler
+	/// @{
+
+	auto handleResponse(std::chrono::system_clock::time_point timeStamp,
+		std::uint16_t sequence,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) -> void final;
+
+	auto handleNotification(
+		std::chrono::system_clock::time_point timeStamp, std::size_t offset, std::span<const std::byte> data) -> void final;
+
+	/// @}
+
 private:
 	// The tasks need access to out private member functions
 	friend class ReadTask<TemplateIoTransaction>;
@@ -137,30 +167,119 @@ private:
 		_ioComponent.get().requestDisconnect(timeStamp);
 	}
 
+	/// @brief This function is called by the "read" task during startup until it returns true.
+	///
+	/// This function waits for the I/O component to finish connecting, and then reads the value once in the background
+	/// using the startup pool of the skill. In pipelined mode, the request is sent directly, and the initial read
+	/// is finished once the response has arrived or the request has timed out.
+	/// @return true if the initial read has finished or could not be performed, or false if it is still pending
+	auto performInitialRead(const process::ExecutionContext &context) -> bool;
 	/// @brief This function is called by the "read" task.
 	///
-	/// This function attempts to read the value if the I/O component is up.
+	/// This function calls performRead(), and records its timing statistics.
 	auto performReadTask(const process::ExecutionContext &context) -> void;
+	/// @brief Performs the work of the "read" task.
+	///
+	/// This function attempts to read the value if the I/O component is up.
+	auto performRead(const process::ExecutionContext &context) -> void;
+	/// @brief Asks the I/O component whether a read may be performed in this cycle, and counts the deferral if not
+	/// @param cycleTime The scheduled time of the current cycle
+	/// @return true if the transaction should be read, or false if the read was deferred to the next cycle
+	auto admitRead(std::chrono::system_clock::time_point cycleTime) -> bool;
+	/// @brief Checks whether a read should be performed in this cycle, if adaptive polling is enabled
+	/// @param timeStamp The scheduled time of the current cycle
+	/// @return true if the transaction should be read, or false if this cycle should be skipped
+	auto readDue(std::chrono::system_clock::time_point timeStamp) -> bool;
+	/// @brief Schedules the next read after a read was performed, if adaptive polling is enabled
+	/// @param timeStamp The scheduled time of the current cycle
+	auto scheduleNextRead(std::chrono::system_clock::time_point timeStamp) -> void;
 	/// @brief Attempts to read the data from the I/O component and updates the state accordingly.
 	auto read(std::chrono::system_clock::time_point timeStamp) -> void;
+	/// @brief Sends a pipelined read request to the I/O component without waiting for the response.
+	///
+	/// The response is delivered later using handleResponse(). If the previous request is still outstanding,
+	/// no new request is sent, and the previous request is abandoned if it has timed out.
+	/// @return false if the read was dropped because the request window of the I/O component was full, or true otherwise
+	auto sendReadRequest(std::chrono::system_clock::time_point timeStamp) -> bool;
+	/// @brief Starts the initial read, or checks whether it has finished
+	/// @return true if the initial read has finished or could not be performed, or false if it is still pending
+	auto advanceInitialRead(const process::ExecutionContext &context) -> bool;
+	/// @brief Checks whether the pipelined request sent by performInitialRead() has finished
+	/// @param timeStamp The current time, used to check whether the request has timed out
+	/// @return true if the request has finished, or false if it is still outstanding
+	auto finishPipelinedInitialRead(std::chrono::system_clock::time_point timeStamp) -> bool;
+	/// @brief Abandons the outstanding pipelined read request, if there is one
+	/// @return true if a request was abandoned, or false if no request was outstanding.
+	auto abandonReadRequest() noexcept -> bool;
 	/// @brief Handles a read error
 	auto handleReadError(std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void;
 
 	/// @brief This function is called by the "write" task.
 	///
-	/// This function attempts to write the value if the I/O component is up.
+	/// This function calls performWrite(), and records its timing statistics.
 	auto performWriteTask(const process::ExecutionContext &context) -> void;
+	/// @brief Performs the work of the "write" task.
+	///
+	/// This function attempts to write the value if the I/O component is up.
+	auto performWrite(const process::ExecutionContext &context) -> void;
 	/// @brief Attempts to write any pending value to the I/O component and updates the state accordingly.
 	auto write(std::chrono::system_clock::time_point timeStamp) -> void;	
 	/// @brief Handles a write error
 	auto handleWriteError(std::chrono::system_clock::time_point timeStamp, std::error_code error, const OutputList &outputs) -> void;
 
+	/// @brief Registers the inputs with the I/O component for change notifications
+	auto subscribe(std::chrono::system_clock::time_point timeStamp) -> void;
+
 	/// @brief Updates the inputs with valid data and sends events
 	/// @param timeStamp The update time stamp
 	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
 	/// containing a read error.
 	auto updateInputs(std::chrono::system_clock::time_point timeStamp,
 		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) -> void;
+	/// @brief Updates the inputs without locking _inputsMutex.
+	///
+	/// The caller must hold the lock on _inputsMutex.
+	/// @param timeStamp The update time stamp
+	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
+	/// containing a read error.
+	auto updateInputsLocked(std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) -> void;
+
+	/// @brief Which inputs must be updated after a read
+	enum class PayloadChanges
+	{
+		/// @brief None of the inputs can have changed
+		None,
+		/// @brief Only the inputs marked in _dirtyInputs, and the inputs without a known payload region, can have changed
+		Partial,
+		/// @brief All of the inputs must be updated
+		All
+	};
+
+	/// @brief Compares the payload of a read command with that of the last read command.
+	/// @param payloadOrError The payload of the read command, or the read error
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @return Which of the inputs must be updated. If this is PayloadChanges::Partial, the affected inputs have been marked
+	/// in _dirtyInputs.
+	auto detectPayloadChanges(
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		const CommonReadState::Changes &commonChanges) -> PayloadChanges;
+
+	/// @brief Determines how large the payload must be to contain the data of all the inputs whose location is known
+	auto expectedPayloadSize() const noexcept -> std::size_t;
+
+	/// @brief Finds runs of inputs that can be decoded in bulk, and fills in _bulkInputRuns, _scaledInputs, _packedBits and _individualInputs
+	auto findBulkInputRuns() -> void;
+
+	/// @brief Updates the individual inputs in parallel using the worker pool, and collects the events to send
+	/// @param writeSentinel The write sentinel for the read data block
+	/// @param timeStamp The update time stamp
+	/// @param payloadOrError The payload of the read command, or the read error
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	auto updateInputsInParallel(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		const CommonReadState::Changes &commonChanges) -> void;
 
 	/// @brief Updates the outputs and sends events
 	/// @param timeStamp The update time stamp
@@ -184,6 +303,40 @@ private:
 	/// @todo give this a more descriptive name, e.g. "_device"
 	std::reference_wrapper<TemplateIoComponent> _ioComponent;
 
+	/// @brief The index of this transaction as a response handler of the I/O component
+	std::uint16_t _responseHandlerIndex;
+
+	/// @brief This structure is used to represent the drop count inside the memory block
+	struct PendingReadState final
+	{
+		/// @brief The number of pipelined reads that were dropped
+		std::uint64_t _droppedReads { 0 };
+	};
+
+	/// @brief The state of the outstanding pipelined read request
+	///
+	/// Each transaction only ever has a single request outstanding, so the request window of the I/O component only
+	/// pipelines requests of different transactions. If the window is full, the read is dropped for this cycle.
+	///
+	/// This is written by the thread that receives the response, so it is kept in its own cache line.
+	struct alignas(kCacheLineSize)
+	{
+		/// @brief The sequence number of the outstanding request, or 0 if no request is outstanding
+		///
+		/// This is reset to 0 by whoever finishes the request, which can be the thread that receives the response,
+		/// the read task if the request timed out, or an I/O component state change. Only the thread that succeeds in resetting
+		/// the sequence number may process the result.
+		std::atomic<std::uint16_t> _sequence { 0 };
+		/// @brief The sequence number that was last used. This is only accessed by the read task.
+		std::uint16_t _lastSequence { 0 };
+		/// @brief The time after which the outstanding request is considered lost. This is only accessed by the read task.
+		std::chrono::system_clock::time_point _deadline;
+		/// @brief The number of reads that were dropped because the request window was full. This is only accessed by the read task.
+		std::uint64_t _droppedReads { 0 };
+		/// @brief The data block that publishes the drop count
+		memory::ObjectBlock<PendingReadState> _dataBlock;
+	} _pendingRead;
+
 	/// @class xentara::plugins::templateDriver::TemplateIoTransaction
 	/// @todo Split read and write command split into several commands each, if necessary.
 	/// 
@@ -197,6 +350,120 @@ private:
 	/// @brief The list of outputs
 	std::vector<std::reference_wrapper<AbstractOutput>> _outputs;
 
+	/// @brief The minimum number of inputs that are decoded in bulk. Shorter runs are decoded input by input.
+	static constexpr std::size_t kMinimumBulkRunLength = 4;
+
+	/// @brief Whether to decode runs of consecutive inputs of the same type in bulk
+	bool _bulkDecode { false };
+	/// @brief The runs of inputs that are decoded in bulk
+	std::vector<std::unique_ptr<AbstractBulkInputRun>> _bulkInputRuns;
+	/// @brief The inputs whose values are scaled from raw values
+	ScaledInputGroup _scaledInputs;
+	/// @brief The Boolean inputs whose values are bits packed together with other bits
+	PackedBitGroup _packedBits;
+	/// @brief The inputs that are not part of any of the runs in _bulkInputRuns, of _scaledInputs, or of _packedBits, and must be
+	/// decoded one by one.
+	std::vector<std::reference_wrapper<AbstractInput>> _individualInputs;
+
+	/// @brief The number of individual inputs that are updated together by a single worker thread, or 0 to update all the
+	/// inputs on the thread executing the read.
+	std::size_t _parallelChunkSize { 0 };
+
+	/// @brief The state used for adaptive polling
+	///
+	/// If adaptive polling is enabled, read cycles are skipped while the payload of the read command does not change. The interval
+	/// between reads is doubled after each read up to the maximum interval, and reset to the minimum interval as soon as a change is seen.
+	struct
+	{
+		/// @brief The minimum interval between reads
+		std::chrono::milliseconds _minimumInterval { 0 };
+		/// @brief The maximum interval between reads, or 0 if adaptive polling is disabled
+		std::chrono::milliseconds _maximumInterval { 0 };
+		/// @brief The interval that will be used after the next read. This is only accessed by the read task.
+		std::chrono::milliseconds _interval { 0 };
+		/// @brief The time of the last read. This is only accessed by the read task.
+		std::chrono::system_clock::time_point _lastRead { std::chrono::system_clock::time_point::min() };
+		/// @brief The time of the next read. This is only accessed by the read task.
+		std::chrono::system_clock::time_point _nextRead { std::chrono::system_clock::time_point::min() };
+		/// @brief Set when a read sees a changed payload, and reset by the read task once it has reacted to it.
+		///
+		/// This is an atomic, because pipelined responses are processed by the thread that receives them.
+		std::atomic<bool> _changeSeen { false };
+	} _adaptivePolling;
+
+	/// @brief This structure is used to represent the deferral count inside the memory block
+	struct CycleBudgetState final
+	{
+		/// @brief The number of reads that were deferred
+		std::uint64_t _deferredReads { 0 };
+	};
+
+	/// @brief The state used to share the cycle budget of the I/O component with other transactions
+	///
+	/// If the I/O component has a cycle budget, the read of this transaction is deferred to the next cycle if the budget
+	/// is used up, unless the priority of the transaction is higher than that of all the other transactions of the I/O component.
+	struct
+	{
+		/// @brief The priority of the transaction
+		std::uint32_t _priority { 0 };
+		/// @brief The index of the transaction returned by TemplateIoComponent::addReadPriority()
+		std::size_t _index { 0 };
+		/// @brief The number of reads that were deferred. This is only accessed by the read task.
+		std::uint64_t _deferredReads { 0 };
+		/// @brief The data block that publishes the deferral count
+		memory::ObjectBlock<CycleBudgetState> _dataBlock;
+	} _cycleBudget;
+
+	/// @brief The state used in subscription mode
+	///
+	/// In subscription mode, the inputs are registered with the I/O component once it is connected, and the I/O component pushes
+	/// changes to the data. The changes are applied to an image of the payload, and the affected inputs are updated. The "read" task
+	/// is then only needed as a slow integrity poll.
+	///
+	/// Reads do not copy their payload into the image. The payload cache always holds the last payload in subscription mode, and
+	/// the image is only refreshed from it when the first notification after a read arrives.
+	struct
+	{
+		/// @brief Whether subscription mode is enabled
+		bool _enabled { false };
+		/// @brief An image of the payload with all notifications applied
+		ReadCommand::Payload _image;
+		/// @brief Whether a read has replaced the payload since _image was last refreshed from the payload cache
+		bool _imageStale { true };
+	} _subscription;
+
+	/// @brief Protects the read data block, the read buffers, and the subscription image.
+	///
+	/// The inputs are updated by the "read" task, by the thread receiving the responses in pipelined mode, by the thread
+	/// receiving the notifications in subscription mode, and by whichever thread reports a change in the state of the I/O component.
+	/// The mutex is only used if _lockInputs is set.
+	std::mutex _inputsMutex;
+	/// @brief Whether updateInputs() must lock _inputsMutex
+	///
+	/// This is only set in pipelined or subscription mode. Plain polling only updates the inputs from the "read" task and,
+	/// like the original template, from ioComponentStateChanged(), and does not need to pay for the lock on every read.
+	bool _lockInputs { false };
+
+	/// @brief Whether to skip decoding the inputs if the payload of a read command is identical to the last one
+	bool _skipUnchangedPayloads { false };
+	/// @brief Whether to only decode the inputs whose data lies within a part of the payload that has changed
+	bool _decodeChangedRegionsOnly { false };
+	/// @brief A copy of the last payload, used if _skipUnchangedPayloads or _decodeChangedRegionsOnly is set, if adaptive polling is enabled,
+	/// or in subscription mode
+	PayloadCache _payloadCache;
+	/// @brief An index of which inputs lie in which blocks of the payload, used if _decodeChangedRegionsOnly is set
+	PayloadRegionIndex _regionIndex;
+	/// @brief A flag for each input that is set if the input's data has changed. This is only used if
+	/// _decodeChangedRegionsOnly is set, and is reset for all inputs after each read.
+	std::vector<std::uint8_t> _dirtyInputs;
+	/// @brief A flag for each input that is set if the input's payload region is known. Inputs without a known
+	/// region are updated whenever any part of the payload has changed. This is only used if _decodeChangedRegionsOnly is set.
+	std::vector<std::uint8_t> _indexedInputs;
+
+	/// @brief The payload of the last read from the simulated device, if the I/O component is simulated. Once the I/O component
+	/// is connected, this is only accessed by the thread of the simulator.
+	ReadCommand::Payload _simulatedPayload;
+
 	/// @brief The read command to send, or nullptr if it hasn't been constructed yet.
 	std::unique_ptr<ReadCommand> _readCommand;
 
@@ -214,29 +481,76 @@ private:
 	/// @brief The data block that holds the data for the outputs
 	DataBlock _writeDataBlock { _writeDataArray };
 
+	/// @brief The memory used by this transaction. This is determined in realize().
+	Footprint _footprint;
+	/// @brief The data block that publishes the memory footprint
+	memory::ObjectBlock<FootprintState> _footprintDataBlock;
+
 	/// @brief The common read state for all inputs
 	CommonReadState _readState;
 	/// @brief The state for the last write command 
 	WriteState _writeState;
 
+	/// @brief The state of the initial read performed during startup
+	enum class InitialReadState : std::uint8_t
+	{
+		/// @brief The initial read has not been started yet
+		NotStarted,
+		/// @brief The initial read is running in the background, or the pipelined request is outstanding
+		Reading,
+		/// @brief The initial read has finished, or could not be performed
+		Done
+	};
+
+	/// @brief The state of the initial read
+	std::atomic<InitialReadState> _initialReadState { InitialReadState::NotStarted };
+	/// @brief Whether we have registered with the startup pool as a participant. This is only accessed by the read task.
+	bool _startupStarted { false };
+	/// @brief Whether we have told the startup pool that our initial read has finished. This is only accessed by the read task.
+	bool _startupFinished { false };
+
 	/// @brief The "read" task
 	ReadTask<TemplateIoTransaction> _readTask { *this };
 	/// @brief The "write" task
 	WriteTask<TemplateIoTransaction> _writeTask { *this };
 
-	/// @brief Preallocated runtime buffers
+	/// @brief The timing statistics of the "read" task
+	TaskStatistics _readStatistics { { attributes::kReadLatency, attributes::kReadMaximumLatency,
+		attributes::kReadDuration, attributes::kReadMaximumDuration, attributes::kReadOverruns } };
+	/// @brief The timing statistics of the "write" task
+	TaskStatistics _writeStatistics { { attributes::kWriteLatency, attributes::kWriteMaximumLatency,
+		attributes::kWriteDuration, attributes::kWriteMaximumDuration, attributes::kWriteOverruns } };
+
+	/// @brief Preallocated runtime buffers for reading
+	///
+	/// This structure contains preallocated buffers for data needed when reading.
+	/// the buffers are preallocated to avoid memory allocations in the read() function,
+	/// which would not be real-time safe.
+	///
+	/// The read and write paths use separate buffers, so that a read and a write of the same transaction can run
+	/// concurrently on different threads.
+	struct
+	{
+		/// @brief The list of events to raise after a read
+		PendingEventList _eventsToRaise;
+
+		/// @brief The events collected by each chunk of inputs, if the inputs are updated in parallel
+		std::vector<PendingEventList> _chunkEvents;
+	} _readBuffers;
+
+	/// @brief Preallocated runtime buffers for writing
 	///
-	/// This structure contains preallocated buffers for data needed when sending commands.
-	/// the buffers are preallocated to avoid memory allocations in the read() and write() functions,
+	/// This structure contains preallocated buffers for data needed when writing.
+	/// the buffers are preallocated to avoid memory allocations in the write() function,
 	/// which would not be real-time safe.
 	struct
 	{
-		/// @brief The list of events to raise after a read or write
+		/// @brief The list of events to raise after a write
 		PendingEventList _eventsToRaise;
 
 		/// @brief The outputs to notify after a write operation
 		OutputList _outputsToNotify;
-	} _runtimeBuffers;
+	} _writeBuffers;
 
 	/// @class xentara::plugins::templateDriver::TemplateIoTransaction::RuntimeBufferSentinel
 	/// @brief A sentinel that performs initialization and cleanup of a runtime buffer
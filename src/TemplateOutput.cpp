@@ -2,7 +2,9 @@
 #include "TemplateOutput.hpp"
 
 #include "AbstractTemplateOutputHandler.hpp"
+#include "KeywordTable.hpp"
 #include "TemplateOutputHandler.hpp"
+#include "TemplateIoComponent.hpp"
 #include "TemplateIoTransaction.hpp"
 
 #include <xentara/config/Context.hpp>
@@ -18,11 +20,50 @@
 
 namespace xentara::plugins::templateDriver
 {
-	
+
 using namespace std::literals;
 
+namespace
+{
+
+/// @brief A function that creates a handler for a specific data type
+using HandlerFactory = auto (*)(HandlerArena &arena) -> HandlerArena::Pointer<AbstractTemplateOutputHandler>;
+
+/// @brief Creates a handler for a specific data type
+template <typename ValueType>
+auto makeHandler(HandlerArena &arena) -> HandlerArena::Pointer<AbstractTemplateOutputHandler>
+{
+	return arena.make<TemplateOutputHandler<ValueType>>();
+}
+
+/// @brief The handler factories for the data type keywords
+/// @todo use keywords that are appropriate to the I/O component
+/// @note Xentara data points only support scalar data types, so array keywords like "float32[1024]" cannot be offered here.
+/// Large sample buffers should be modelled as individual outputs in a single I/O transaction with the option "bulkDecode"
+/// enabled instead. Their values are then stored and decoded contiguously, just like the elements of an array would be.
+constexpr KeywordTable<HandlerFactory, 12> kHandlerFactories { { {
+	{ "bool"sv, &makeHandler<bool> },
+	{ "uint8"sv, &makeHandler<std::uint8_t> },
+	{ "uint16"sv, &makeHandler<std::uint16_t> },
+	{ "uint32"sv, &makeHandler<std::uint32_t> },
+	{ "uint64"sv, &makeHandler<std::uint64_t> },
+	{ "int8"sv, &makeHandler<std::int8_t> },
+	{ "int16"sv, &makeHandler<std::int16_t> },
+	{ "int32"sv, &makeHandler<std::int32_t> },
+	{ "int64"sv, &makeHandler<std::int64_t> },
+	{ "float32"sv, &makeHandler<float> },
+	{ "float64"sv, &makeHandler<double> },
+	{ "string"sv, &makeHandler<std::string> }
+} } };
+
+} // namespace
+
 auto TemplateOutput::load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void
 {
+	// The handler is allocated from the arena of the I/O component, so that the handlers of data points that are loaded
+	// one after the other lie next to each other in memory
+	_handlerArena = _ioComponent.get().handlerArena();
+
 	// Go through all the members of the JSON object that represents this object
 	bool ioTransactionLoaded = false;
 	for (auto && [name, value] : jsonObject)
@@ -43,6 +84,10 @@ auto TemplateOutput::load(utils::json::decoder::Object &jsonObject, config::Cont
 				});
 			ioTransactionLoaded = true;
 		}
+		else if (name == "offset"sv)
+		{
+			_offset = value.asNumber<std::size_t>();
+		}
 		/// @todo load custom configuration parameters
 		else if (name == "TODO"sv)
 		{
@@ -84,69 +129,20 @@ auto TemplateOutput::load(utils::json::decoder::Object &jsonObject, config::Cont
 	}
 }
 
-auto TemplateOutput::createHandler(utils::json::decoder::Value &value) -> std::unique_ptr<AbstractTemplateOutputHandler>
+auto TemplateOutput::createHandler(utils::json::decoder::Value &value) -> HandlerArena::Pointer<AbstractTemplateOutputHandler>
 {
 	// Get the keyword from the value
 	auto keyword = value.asString<std::string>();
-	
-	/// @todo use keywords that are appropriate to the I/O component
-	if (keyword == "bool"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<bool>>();
-	}
-	else if (keyword == "uint8"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<std::uint8_t>>();
-	}
-	else if (keyword == "uint16"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<std::uint16_t>>();
-	}
-	else if (keyword == "uint32"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<std::uint32_t>>();
-	}
-	else if (keyword == "uint64"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<std::uint64_t>>();
-	}
-	else if (keyword == "int8"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<std::int8_t>>();
-	}
-	else if (keyword == "int16"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<std::int16_t>>();
-	}
-	else if (keyword == "int32"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<std::int32_t>>();
-	}
-	else if (keyword == "int64"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<std::int64_t>>();
-	}
-	else if (keyword == "float32"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<float>>();
-	}
-	else if (keyword == "float64"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<double>>();
-	}
-	else if (keyword == "string"sv)
-	{
-		return std::make_unique<TemplateOutputHandler<std::string>>();
-	}
 
-	// The keyword is not known
-	else
+	// Look up the keyword
+	const auto factory = kHandlerFactories.find(keyword);
+	if (!factory)
 	{
 		/// @todo replace "template output" with a more descriptive name
 		utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown data type in template output"));
 	}
 
-	return std::unique_ptr<AbstractTemplateOutputHandler>();
+	return (*factory)(*_handlerArena);
 }
 
 auto TemplateOutput::dataType() const -> const data::DataType &
@@ -167,6 +163,42 @@ auto TemplateOutput::directions() const -> io::Directions
 	return io::Direction::Input | io::Direction::Output;
 }
 
+auto TemplateOutput::payloadRegion() const noexcept -> std::optional<PayloadRegion>
+{
+	// We need both the offset and the size
+	if (!_offset || !_handler)
+	{
+		return std::nullopt;
+	}
+	const auto size = _handler->encodedSize();
+	if (!size)
+	{
+		return std::nullopt;
+	}
+
+	return PayloadRegion { ._offset = *_offset, ._size = *size };
+}
+
+auto TemplateOutput::bulkReadState() noexcept -> BulkReadState
+{
+	if (!_handler)
+	{
+		return std::monostate {};
+	}
+
+	return _handler->bulkReadState();
+}
+
+auto TemplateOutput::handlerFootprint() const noexcept -> Footprint
+{
+	if (!_handler)
+	{
+		return {};
+	}
+
+	return _handler->footprint();
+}
+
 auto TemplateOutput::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
 {
 	// forEachAttribute() must not be called before the configuration was loaded, so the handler should have been
@@ -294,7 +326,20 @@ auto TemplateOutput::updateReadState(WriteSentinel &writeSentinel,
 	}
 
 	// Forward the request to the handler
-	_handler->updateReadState(writeSentinel, timeStamp, payloadOrError, commonChanges, eventsToRaise);
+	_handler->updateReadState(writeSentinel, timeStamp, payloadOrError, _offset, commonChanges, eventsToRaise);
+}
+
+auto TemplateOutput::keepReadState(WriteSentinel &writeSentinel) -> void
+{
+	// keepReadState() must not be called before the configuration was loaded, so the handler should have been
+	// created already.
+	if (!_handler) [[unlikely]]
+	{
+		throw std::logic_error("internal error: xentara::plugins::templateDriver::TemplateOutput::keepReadState() called before configuration has been loaded");
+	}
+
+	// Forward the request to the handler
+	_handler->keepReadState(writeSentinel);
 }
 
 auto TemplateOutput::addToWriteCommand(WriteCommand &command) -> bool
@@ -307,7 +352,7 @@ auto TemplateOutput::addToWriteCommand(WriteCommand &command) -> bool
 	}
 
 	// Forward the request to the handler
-	return _handler->addToWriteCommand(command);
+	return _handler->addToWriteCommand(command, _offset);
 }
 
 auto TemplateOutput::attachOutput(memory::Array &dataArray, std::size_t &eventCount) -> void
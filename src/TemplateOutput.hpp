@@ -4,6 +4,7 @@
 #include "AbstractTemplateOutputHandler.hpp"
 #include "AbstractInput.hpp"
 #include "AbstractOutput.hpp"
+#include "HandlerArena.hpp"
 
 #include <xentara/process/Task.hpp>
 #include <xentara/skill/DataPoint.hpp>
@@ -11,6 +12,8 @@
 #include <xentara/utils/json/decoder/Value.hpp>
 
 #include <functional>
+#include <memory>
+#include <optional>
 #include <string_view>
 
 namespace xentara::plugins::templateDriver
@@ -69,6 +72,22 @@ public:
 	{
 		return _ioComponent;
 	}
+
+	auto payloadRegion() const noexcept -> std::optional<PayloadRegion> final;
+
+	auto bulkReadState() noexcept -> BulkReadState final;
+
+	auto scaledReadState() noexcept -> std::optional<ScaledReadState> final
+	{
+		return std::nullopt;
+	}
+
+	auto packedBitReadState() noexcept -> std::optional<PackedBitReadState> final
+	{
+		return std::nullopt;
+	}
+
+	auto handlerFootprint() const noexcept -> Footprint final;
 	
 	auto attachInput(memory::Array &dataArray, std::size_t &eventCount) -> void final;
 
@@ -77,6 +96,8 @@ public:
 		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
 		const CommonReadState::Changes &commonChanges,
 		PendingEventList &eventsToRaise) -> void final;
+
+	auto keepReadState(WriteSentinel &writeSentinel) -> void final;
 	
 	/// @}
 
@@ -97,7 +118,7 @@ public:
 
 private:
 	/// @brief Creates an output handler based on a configuration value
-	auto createHandler(utils::json::decoder::Value &value) -> std::unique_ptr<AbstractTemplateOutputHandler>;
+	auto createHandler(utils::json::decoder::Value &value) -> HandlerArena::Pointer<AbstractTemplateOutputHandler>;
 
 	/// @name Virtual Overrides for skill::DataPoint
 	/// @{
@@ -114,11 +135,17 @@ private:
 	/// @todo give this a more descriptive name, e.g. "_poll"
 	TemplateIoTransaction *_ioTransaction { nullptr };
 
+	/// @brief The arena the handler is allocated from. This must be declared before _handler, so that it is destroyed after it.
+	std::shared_ptr<HandlerArena> _handlerArena;
+
 	/// @brief The handler for data type specific functionality, or nullptr, if the data type hans not been loaded yet
-	std::unique_ptr<AbstractTemplateOutputHandler> _handler;
+	HandlerArena::Pointer<AbstractTemplateOutputHandler> _handler;
+
+	/// @brief The offset of the value within the payload of the read command, or std::nullopt if it is unknown.
+	std::optional<std::size_t> _offset;
 
 	/// @class xentara::plugins::templateDriver::TemplateOutput
-	/// @todo add information needed to decode the value from the payload of a read command, like e.g. a data offset.
+	/// @todo add any other information needed to decode the value from the payload of a read command.
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
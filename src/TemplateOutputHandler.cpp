@@ -2,7 +2,10 @@
 #include "TemplateOutputHandler.hpp"
 
 #include "Attributes.hpp"
+#include "ByteOrder.hpp"
+#include "CustomError.hpp"
 #include "TemplateIoTransaction.hpp"
+#include "WriteCommand.hpp"
 
 #include <xentara/data/DataType.hpp>
 #include <xentara/data/ReadHandle.hpp>
@@ -11,6 +14,10 @@
 #include <xentara/model/Attribute.hpp>
 #include <xentara/utils/tools/Concepts.hpp>
 
+#include <array>
+#include <functional>
+#include <span>
+
 namespace xentara::plugins::templateDriver
 {
 	
@@ -19,6 +26,14 @@ using namespace std::literals;
 template <typename ValueType>
 const model::Attribute TemplateOutputHandler<ValueType>::kValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadWrite, staticDataType() };
 
+template <typename ValueType>
+const AttributeTable<typename TemplateOutputHandler<ValueType>::ReadHandleSource> TemplateOutputHandler<ValueType>::kReadHandleSources {
+	{ std::array { std::cref(kValueAttribute) }, ReadHandleSource::Value },
+	{ PerValueReadState<ValueType>::attributes(), ReadHandleSource::ReadState },
+	{ CommonReadState::attributes(), ReadHandleSource::CommonReadState },
+	{ WriteState::attributes(), ReadHandleSource::WriteState }
+};
+
 template <typename ValueType>
 constexpr auto TemplateOutputHandler<ValueType>::staticDataType() -> const data::DataType &
 {
@@ -49,6 +64,42 @@ auto TemplateOutputHandler<ValueType>::dataType() const -> const data::DataType
 	return kValueAttribute.dataType();
 }
 
+template <typename ValueType>
+auto TemplateOutputHandler<ValueType>::encodedSize() const noexcept -> std::optional<std::size_t>
+{
+	/// @todo return the number of bytes the value actually occupies in the payload of a read command
+	if constexpr (utils::tools::StringType<ValueType>)
+	{
+		// Strings have a variable size
+		return std::nullopt;
+	}
+	else
+	{
+		return sizeof(ValueType);
+	}
+}
+
+template <typename ValueType>
+auto TemplateOutputHandler<ValueType>::bulkReadState() noexcept -> BulkReadState
+{
+	// Only integers and floating point values can be decoded in bulk
+	if constexpr (utils::tools::Integral<ValueType> || std::floating_point<ValueType>)
+	{
+		return &_readState;
+	}
+	else
+	{
+		return std::monostate {};
+	}
+}
+
+template <typename ValueType>
+auto TemplateOutputHandler<ValueType>::footprint() const noexcept -> Footprint
+{
+	// Count the queue separately
+	return { ._handlerBytes = sizeof(*this) - sizeof(_pendingOutputValue), ._queueBytes = sizeof(_pendingOutputValue) };
+}
+
 template <typename ValueType>
 auto TemplateOutputHandler<ValueType>::forEachAttribute(const model::ForEachAttributeFunction &function, TemplateIoTransaction &ioTransaction) const -> bool
 {
@@ -81,31 +132,25 @@ auto TemplateOutputHandler<ValueType>::forEachEvent(const model::ForEachEventFun
 template <typename ValueType>
 auto TemplateOutputHandler<ValueType>::makeReadHandle(const model::Attribute &attribute, TemplateIoTransaction &ioTransaction) const noexcept -> std::optional<data::ReadHandle>
 {
-	// Get the data blocks
-	const auto &readDataBlock = ioTransaction.readDataBlock();
-	const auto &writeDataBlock = ioTransaction.writeDataBlock();
-	
-	// Handle the value attribute separately
-	if (attribute == kValueAttribute)
-	{
-		return _readState.valueReadHandle(readDataBlock);
-	}
-	
-	// Handle the read state attributes
-	if (auto handle = _readState.makeReadHandle(readDataBlock, attribute))
+	// Find out which part of the handler provides the attribute
+	const auto source = kReadHandleSources.find(attribute);
+	if (!source)
 	{
-		return handle;
-	}
-	// Also handle the common read state attributes from the I/O transaction
-	if (auto handle = ioTransaction.makeReadStateReadHandle(attribute))
-	{
-		return handle;
+		return std::nullopt;
 	}
 
-	// Handle the write state attributes
-	if (auto handle = _writeState.makeReadHandle(writeDataBlock, attribute))
+	// Ask the correct part for the handle
+	switch (source->_route)
 	{
-		return handle;
+	case ReadHandleSource::Value:
+		return _readState.valueReadHandle(ioTransaction.readDataBlock());
+	case ReadHandleSource::ReadState:
+		return _readState.makeReadHandle(ioTransaction.readDataBlock(), source->_index);
+	case ReadHandleSource::CommonReadState:
+		// The common read state attributes are inherited from the I/O transaction
+		return ioTransaction.makeReadStateReadHandle(source->_index);
+	case ReadHandleSource::WriteState:
+		return _writeState.makeReadHandle(ioTransaction.writeDataBlock(), source->_index);
 	}
 
 	return std::nullopt;
@@ -138,14 +183,37 @@ template <typename ValueType>
 auto TemplateOutputHandler<ValueType>::updateReadState(WriteSentinel &writeSentinel,
 	std::chrono::system_clock::time_point timeStamp,
 	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+	std::optional<std::size_t> offset,
 	const CommonReadState::Changes &commonChanges,
 	PendingEventList &eventsToRaise) -> void
 {
 	// Check if we have a valid payload
 	if (payloadOrError)
 	{
-		/// @todo decode the value from the payload data
+		/// @todo decode values that are not simply stored at their offset in the byte order of the I/O component.
 		ValueType value = {};
+		if (offset)
+		{
+			// Make sure the payload contains the value
+			const auto data = payloadOrError->get().data();
+			const auto size = encodedSize();
+			if (size && (*offset > data.size() || data.size() - *offset < *size))
+			{
+				_readState.update(writeSentinel, timeStamp, utils::eh::unexpected(std::error_code(CustomError::PayloadTooShort)), commonChanges, eventsToRaise);
+				return;
+			}
+
+			// Decode numbers using the byte order of the I/O component, and treat any non-zero byte as true
+			if constexpr (byteOrder::Decodable<ValueType>)
+			{
+				value = byteOrder::decode<ValueType>(data.data() + *offset);
+			}
+			else if constexpr (std::same_as<ValueType, bool>)
+			{
+				value = data[*offset] != std::byte { 0 };
+			}
+			/// @todo decode strings
+		}
 		
 		/// @todo it may be advantageous to split the decoding of the value up according to value type, either by using helper functions,
 		/// or using if constexpr().
@@ -188,6 +256,12 @@ auto TemplateOutputHandler<ValueType>::updateReadState(WriteSentinel &writeSenti
 	}
 }
 
+template <typename ValueType>
+auto TemplateOutputHandler<ValueType>::keepReadState(WriteSentinel &writeSentinel) -> void
+{
+	_readState.keep(writeSentinel);
+}
+
 template <typename ValueType>
 auto TemplateOutputHandler<ValueType>::attachWriteState(memory::Array &dataArray, std::size_t &eventCount) -> void
 {
@@ -195,7 +269,7 @@ auto TemplateOutputHandler<ValueType>::attachWriteState(memory::Array &dataArray
 }
 
 template <typename ValueType>
-auto TemplateOutputHandler<ValueType>::addToWriteCommand(WriteCommand &command) -> bool
+auto TemplateOutputHandler<ValueType>::addToWriteCommand(WriteCommand &command, std::optional<std::size_t> offset) -> bool
 {
 	// Get the value
 	auto pendingValue = _pendingOutputValue.dequeue();
@@ -205,7 +279,20 @@ auto TemplateOutputHandler<ValueType>::addToWriteCommand(WriteCommand &command)
 		return false;
 	}
 
-	/// @todo add the value to the command
+	// Encode the value at its offset. Numbers are converted to the byte order of the I/O component using the conversion kernels.
+	if (offset)
+	{
+		if constexpr (byteOrder::Decodable<ValueType>)
+		{
+			byteOrder::encode(std::span<const ValueType>(&*pendingValue, 1), command.region(*offset, sizeof(ValueType)).data());
+		}
+		else if constexpr (std::same_as<ValueType, bool>)
+		{
+			command.region(*offset, 1).front() = std::byte(*pendingValue ? 1 : 0);
+		}
+	}
+
+	/// @todo add values without an offset, and values that cannot be encoded like this, like strings, to the command.
 
 	/// @todo it may be advantageous to split this function up according to value type, either using explicit 
 	/// template specialization, or using if constexpr().
@@ -2,12 +2,14 @@
 #pragma once
 
 #include "AbstractTemplateOutputHandler.hpp"
+#include "AttributeTable.hpp"
 #include "PerValueReadState.hpp"
 #include "WriteState.hpp"
 #include "SingleValueQueue.hpp"
 
 #include <xentara/model/Attribute.hpp>
 
+#include <cstdint>
 #include <string>
 
 namespace xentara::plugins::templateDriver
@@ -33,6 +35,12 @@ public:
 
 	auto dataType() const -> const data::DataType & final;
 
+	auto encodedSize() const noexcept -> std::optional<std::size_t> final;
+
+	auto bulkReadState() noexcept -> BulkReadState final;
+
+	auto footprint() const noexcept -> Footprint final;
+
 	auto forEachAttribute(const model::ForEachAttributeFunction &function, TemplateIoTransaction &ioTransaction) const -> bool final;
 
 	auto forEachEvent(const model::ForEachEventFunction &function, TemplateIoTransaction &ioTransaction, std::shared_ptr<void> parent) -> bool final;
@@ -46,10 +54,13 @@ public:
 	auto updateReadState(WriteSentinel &writeSentinel,
 		std::chrono::system_clock::time_point timeStamp,
 		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
+		std::optional<std::size_t> offset,
 		const CommonReadState::Changes &commonChanges,
 		PendingEventList &eventsToRaise) -> void final;
+
+	auto keepReadState(WriteSentinel &writeSentinel) -> void final;
 	
-	auto addToWriteCommand(WriteCommand &command) -> bool final;
+	auto addToWriteCommand(WriteCommand &command, std::optional<std::size_t> offset) -> bool final;
 
 	auto attachWriteState(memory::Array &dataArray, std::size_t &eventCount) -> void final;
 
@@ -72,6 +83,22 @@ private:
 	/// This function returns the same value as dataType(), but is static and constexpr.
 	static constexpr auto staticDataType() -> const data::DataType &;
 
+	/// @brief The parts of the handler that provide the read handles for the attributes
+	enum class ReadHandleSource : std::uint8_t
+	{
+		/// @brief The value, provided by _readState
+		Value,
+		/// @brief The per-value read state in _readState
+		ReadState,
+		/// @brief The common read state of the I/O transaction
+		CommonReadState,
+		/// @brief The write state in _writeState
+		WriteState
+	};
+
+	/// @brief The readable attributes, and the parts of the handler that provide the read handles for them
+	static const AttributeTable<ReadHandleSource> kReadHandleSources;
+
 	/// @brief Schedules a value to be written.
 	///
 	/// This function is called by the value write handle.
@@ -1,12 +1,16 @@
 // Copyright (c) embedded ocean GmbH
 #pragma once
 
+#include "Footprint.hpp"
+
 #include <xentara/memory/Array.hpp>
 #include <xentara/memory/ArrayBlock.hpp>
 #include <xentara/memory/WriteSentinel.hpp>
 #include <xentara/process/EventList.hpp>
 #include <xentara/utils/core/FixedVector.hpp>
 
+#include <cstddef>
+
 namespace xentara::plugins::templateDriver
 {
 
@@ -24,4 +28,22 @@ using PendingEventList = process::FixedEventList;
 /// @brief This is the type used to hold the list of outputs to notify
 using OutputList = utils::core::FixedVector<std::reference_wrapper<AbstractOutput>>;
 
+/// @brief The assumed size of a cache line.
+///
+/// This is used to keep data that is written by different threads in separate cache lines, so that the threads do not
+/// slow each other down through false sharing.
+inline constexpr std::size_t kCacheLineSize = 64;
+
+/// @brief An empty object that occupies an entire cache line
+struct alignas(kCacheLineSize) CacheLinePadding
+{
+};
+
+/// @brief Appends padding to an array, so that the objects appended before and after never share a cache line.
+/// @param dataArray The array to append the padding to
+inline auto separateCacheLines(memory::Array &dataArray) -> void
+{
+	appendObject<CacheLinePadding>(dataArray);
+}
+
 } // namespace xentara::plugins::templateDriver
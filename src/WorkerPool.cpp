@@ -0,0 +1,140 @@
+// Copyright (c) embedded ocean GmbH
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+WorkerPool::~WorkerPool()
+{
+	// Request all threads to stop
+	for (auto &&thread : _threads)
+	{
+		thread.request_stop();
+	}
+
+	// Wake up the threads, so they will notice
+	_generation.fetch_add(1, std::memory_order_release);
+	_generation.notify_all();
+
+	// The std::jthread objects will join the threads when they are destroyed
+}
+
+auto WorkerPool::start() -> void
+{
+	// Don't start the threads twice
+	if (!_threads.empty())
+	{
+		return;
+	}
+
+	// Use one thread less than the number of cores, because the calling thread participates in each job, but keep the pool small
+	const auto threadCount = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 2u) - 1, kMaximumThreadCount);
+
+	// Capture the generation before starting the threads, so that a job started before a thread first runs is not missed
+	const auto generation = _generation.load(std::memory_order_acquire);
+
+	_threads.reserve(threadCount);
+	for (std::size_t index = 0; index < threadCount; ++index)
+	{
+		_threads.emplace_back([this, generation](std::stop_token stopToken) { workerFunction(stopToken, generation); });
+	}
+}
+
+auto WorkerPool::runJob(std::size_t chunkCount, ChunkFunction function, void *context) -> void
+{
+	// If the pool is not running, or is busy with a job from another thread, just process all the chunks here
+	if (_threads.empty() || _busy.test_and_set(std::memory_order_acquire))
+	{
+		for (std::size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+		{
+			function(context, chunkIndex);
+		}
+		return;
+	}
+
+	// Set up the job
+	_job._function = function;
+	_job._context = context;
+	_job._chunkCount = chunkCount;
+	_job._exception = nullptr;
+	_job._failed.clear(std::memory_order_relaxed);
+	_nextChunk.store(0, std::memory_order_relaxed);
+	_pendingWorkers.store(_threads.size(), std::memory_order_relaxed);
+
+	// Wake up the workers
+	_generation.fetch_add(1, std::memory_order_release);
+	_generation.notify_all();
+
+	// Do our share of the work
+	processChunks();
+
+	// Wait for all the workers to leave the job, so that none of them can still be accessing it when we return
+	for (auto pendingWorkers = _pendingWorkers.load(std::memory_order_acquire); pendingWorkers != 0;
+		 pendingWorkers = _pendingWorkers.load(std::memory_order_acquire))
+	{
+		_pendingWorkers.wait(pendingWorkers, std::memory_order_acquire);
+	}
+
+	// Get the exception, if any
+	auto exception = std::exchange(_job._exception, nullptr);
+
+	// Release the pool
+	_busy.clear(std::memory_order_release);
+
+	// Rethrow the exception from the job, if there was one
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
+auto WorkerPool::processChunks() noexcept -> void
+{
+	// Take chunks until there are none left
+	for (auto chunkIndex = _nextChunk.fetch_add(1, std::memory_order_relaxed); chunkIndex < _job._chunkCount;
+		 chunkIndex = _nextChunk.fetch_add(1, std::memory_order_relaxed))
+	{
+		try
+		{
+			_job._function(_job._context, chunkIndex);
+		}
+		catch (...)
+		{
+			// Remember the first exception
+			if (!_job._failed.test_and_set(std::memory_order_relaxed))
+			{
+				_job._exception = std::current_exception();
+			}
+		}
+	}
+}
+
+auto WorkerPool::workerFunction(std::stop_token stopToken, std::uint32_t generation) -> void
+{
+	while (true)
+	{
+		// Wait for the next job
+		_generation.wait(generation, std::memory_order_acquire);
+		generation = _generation.load(std::memory_order_acquire);
+
+		// Stop if requested
+		if (stopToken.stop_requested())
+		{
+			return;
+		}
+
+		// Do our share of the work
+		processChunks();
+
+		// Notify the calling thread once all the workers are done
+		if (_pendingWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			_pendingWorkers.notify_all();
+		}
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
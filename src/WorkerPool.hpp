@@ -0,0 +1,106 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+
+#include <xentara/utils/tools/Unique.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A small pool of worker threads used to process large batches of data in parallel.
+///
+/// A job consists of a number of chunks that are processed independently. The worker threads and the calling thread take
+/// chunks from a shared counter until all chunks have been taken, so that threads that finish early automatically take over
+/// the remaining work of the others.
+///
+/// The pool only processes one job at a time. If the pool is already busy with a job from another thread, the job is processed
+/// entirely on the calling thread instead of waiting for the pool to become available.
+class WorkerPool final : private utils::tools::Unique
+{
+public:
+	/// @brief The destructor stops the worker threads
+	~WorkerPool();
+
+	/// @brief Starts the worker threads, if they are not running yet.
+	///
+	/// This function must be called by all elements that intend to use the pool, before the Xentara tasks are started.
+	/// It is not thread-safe, and is intended to be called from skill::Element::realize().
+	auto start() -> void;
+
+	/// @brief Calls a function for each chunk of a job in parallel.
+	/// @param chunkCount The number of chunks
+	/// @param function A function that will be called with each chunk index from 0 to *chunkCount* - 1. The function will
+	/// be called concurrently from different threads.
+	/// @throw If the function throws an exception for any of the chunks, the first exception is rethrown once all the chunks
+	/// have been processed.
+	template <std::invocable<std::size_t> Function>
+	auto forEachChunk(std::size_t chunkCount, Function &&function) -> void
+	{
+		// Use a type-erased pointer to the function, so we don't need any memory allocations
+		using FunctionType = std::remove_reference_t<Function>;
+		runJob(
+			chunkCount,
+			[](void *context, std::size_t chunkIndex) { (*static_cast<FunctionType *>(context))(chunkIndex); },
+			const_cast<void *>(static_cast<const void *>(std::addressof(function))));
+	}
+
+private:
+	/// @brief The maximum number of worker threads
+	static constexpr std::size_t kMaximumThreadCount = 3;
+
+	/// @brief A type erased chunk function
+	using ChunkFunction = void (*)(void *context, std::size_t chunkIndex);
+
+	/// @brief Runs a job
+	auto runJob(std::size_t chunkCount, ChunkFunction function, void *context) -> void;
+
+	/// @brief Processes chunks of the current job until no more chunks are left
+	auto processChunks() noexcept -> void;
+
+	/// @brief The function executed by the worker threads
+	/// @param stopToken The stop token of the thread
+	/// @param generation The value of _generation when the thread was started. The thread joins every job started after that.
+	auto workerFunction(std::stop_token stopToken, std::uint32_t generation) -> void;
+
+	/// @brief The current job
+	struct
+	{
+		/// @brief The function to call
+		ChunkFunction _function { nullptr };
+		/// @brief The context to pass to the function
+		void *_context { nullptr };
+		/// @brief The number of chunks
+		std::size_t _chunkCount { 0 };
+		/// @brief The first exception thrown by the function, if any
+		std::exception_ptr _exception;
+		/// @brief Set once an exception was stored in _exception
+		std::atomic_flag _failed;
+	} _job;
+
+	/// @brief Set while a job is running
+	std::atomic_flag _busy;
+	/// @brief The index of the next chunk to process
+	///
+	/// This is modified by all threads while a job is running, so it is kept in its own cache line.
+	alignas(kCacheLineSize) std::atomic<std::size_t> _nextChunk { 0 };
+	/// @brief The number of worker threads that have not finished the current job yet
+	alignas(kCacheLineSize) std::atomic<std::size_t> _pendingWorkers { 0 };
+	/// @brief Incremented whenever a new job is started, or the workers should stop.
+	std::atomic<std::uint32_t> _generation { 0 };
+
+	/// @brief The worker threads
+	std::vector<std::jthread> _threads;
+};
+
+} // namespace xentara::plugins::templateDriver
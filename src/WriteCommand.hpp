@@ -3,6 +3,10 @@
 
 #include <xentara/utils/tools/Unique.hpp>
 
+#include <cstddef>
+#include <span>
+#include <vector>
+
 namespace xentara::plugins::templateDriver
 {
 
@@ -10,6 +14,33 @@ namespace xentara::plugins::templateDriver
 /// @todo implement a proper write command
 class WriteCommand final : private utils::tools::Unique
 {
+public:
+	/// @brief Gets the raw data to send to the device
+	auto data() const noexcept -> std::span<const std::byte>
+	{
+		return _data;
+	}
+
+	/// @brief Gets a part of the raw data, so that a value can be encoded into it.
+	///
+	/// The data is enlarged if necessary. New bytes are set to zero.
+	/// @param offset The offset of the part within the data
+	/// @param size The size of the part
+	/// @return The part of the data
+	auto region(std::size_t offset, std::size_t size) -> std::span<std::byte>
+	{
+		if (_data.size() < offset + size)
+		{
+			_data.resize(offset + size);
+		}
+
+		return std::span(_data).subspan(offset, size);
+	}
+
+private:
+	/// @brief The raw data
+	/// @todo use the data representation of the protocol, if it has one
+	std::vector<std::byte> _data;
 };
 
-} // namespace xentara::plugins::templateDriver
\ No newline at end of file
+} // namespace xentara::plugins::templateDriver
@@ -3,9 +3,11 @@
 
 #include "Attributes.hpp"
 #include "Events.hpp"
+#include "Footprint.hpp"
 
 #include <xentara/memory/WriteSentinel.hpp>
 
+#include <algorithm>
 #include <string_view>
 
 namespace xentara::plugins::templateDriver
@@ -13,12 +15,16 @@ namespace xentara::plugins::templateDriver
 
 using namespace std::literals;
 
+auto WriteState::attributes() noexcept -> std::array<std::reference_wrapper<const model::Attribute>, AttributeCount>
+{
+	// Return all the attributes we support, in the order given by AttributeIndex
+	return { { model::Attribute::kWriteTime, attributes::kWriteError } };
+}
+
 auto WriteState::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
 {
 	// Handle all the attributes we support
-	return
-		function(model::Attribute::kWriteTime) ||
-		function(attributes::kWriteError);
+	return std::ranges::any_of(attributes(), [&](const model::Attribute &attribute) { return function(attribute); });
 }
 
 auto WriteState::forEachEvent(const model::ForEachEventFunction &function, std::shared_ptr<void> parent) -> bool
@@ -31,13 +37,24 @@ auto WriteState::forEachEvent(const model::ForEachEventFunction &function, std::
 
 auto WriteState::makeReadHandle(const DataBlock &dataBlock, const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
 {
-	// Try each readable attribute
-	if (attribute == model::Attribute::kWriteTime)
+	// Find the position of the attribute in our attribute list
+	const auto list = attributes();
+	const auto entry = std::ranges::find_if(list, [&](const model::Attribute &candidate) { return candidate == attribute; });
+	if (entry == list.end())
 	{
-		return dataBlock.member(_stateHandle, &State::_writeTime);
+		return std::nullopt;
 	}
-	else if (attribute == attributes::kWriteError)
+
+	return makeReadHandle(dataBlock, std::size_t(entry - list.begin()));
+}
+
+auto WriteState::makeReadHandle(const DataBlock &dataBlock, std::size_t index) const noexcept -> std::optional<data::ReadHandle>
+{
+	switch (index)
 	{
+	case WriteTimeIndex:
+		return dataBlock.member(_stateHandle, &State::_writeTime);
+	case WriteErrorIndex:
 		return dataBlock.member(_stateHandle, &State::_writeError);
 	}
 
@@ -47,7 +64,7 @@ auto WriteState::makeReadHandle(const DataBlock &dataBlock, const model::Attribu
 auto WriteState::attach(memory::Array &dataArray, std::size_t &eventCount) -> void
 {
 	// Add the state to the array
-	_stateHandle = dataArray.appendObject<State>();
+	_stateHandle = appendObject<State>(dataArray);
 
 	// Add the number of events that can be raised at once.
 	// This is only one, not two, because _writtenEvent and _writeErrorEvent are mutually exclusive